@@ -9,6 +9,7 @@
 
 #include <fatal/container/variant.h>
 #include <fatal/type/call_traits.h>
+#include <fatal/type/map.h>
 #include <fatal/type/prefix_tree.h>
 #include <fatal/type/string.h>
 
@@ -183,11 +184,12 @@ private:
     supported::transform<metadata::to_constructor_command>
   >;
   using built_ins = fatal::type_list<metadata::str::create, metadata::str::json, metadata::str::help>;
-  using command_trie = op_list::transform<get_member::verb>::concat<built_ins>
-    ::apply<fatal::type_prefix_tree_builder<>::build>;
+  using command_trie = built_ins::apply<fatal::type_prefix_tree_builder<>::build>;
   using op_trie = op_list::transform<get_member::verb>::apply<fatal::type_prefix_tree_builder<>::build>;
   // data_type -> verb -> op
   using op_index = fatal::clustered_index<op_list, fatal::get_member_typedef::type, get_member::verb>;
+  // (instance tag, verb index) -> op, in a single dispatch table
+  using op_dispatch = fatal::clustered_dispatch<op_index, instance_t::types, op_trie::sequences::list>;
   using instances_map = std::unordered_map<std::string, instance_t>;
 
   template <typename T, typename TArgsList, std::size_t... Indexes>
@@ -206,38 +208,23 @@ private:
     });
   }
 
-  template <typename TVerb>
   struct call_visitor {
-    template <typename T>
-    void operator ()(T &&instance, result_t &out, request_args &args) {
-      using op_map = op_index::template find<typename std::decay<T>::type>;
-
-      auto found = op_map::template visit<TVerb>([&](auto op_pair) { // type_pair<type_string, operation>
-        using op = typename decltype(op_pair)::second;
-
-        if (op::args::size != args.size()) { throw std::invalid_argument("arguments list size mismatch"); }
-
-        using arg_indexes = fatal::constant_range<std::size_t, 0, op::args::size>;
+    template <typename T, typename TVerb, typename TOp, std::size_t Index>
+    void operator ()(
+      fatal::indexed_type_tag<fatal::type_pair<fatal::type_list<T, TVerb>, TOp>, Index>,
+      instance_t &instance, result_t &out, request_args &args
+    ) const {
+      if (TOp::args::size != args.size()) { throw std::invalid_argument("arguments list size mismatch"); }
 
-        call_method<typename op::method, typename op::result, typename op::args>(
-          arg_indexes(), out, std::forward<T>(instance), args
-        );
-      });
+      using arg_indexes = fatal::constant_range<std::size_t, 0, TOp::args::size>;
 
-      if (!found) { throw std::invalid_argument("invalid operation"); }
+      call_method<typename TOp::method, typename TOp::result, typename TOp::args>(
+        arg_indexes(), out, instance.template get<T>(), args
+      );
     }
   };
 
   struct command_parser {
-    template <typename TVerb>
-    void operator ()(fatal::type_tag<TVerb>, instances_map &instances, request_args &args, result_t &out) const {
-      auto i = instances.find(args.next<std::string>());
-      if (i == instances.end()) { throw std::invalid_argument("instance not found"); }
-      if (!i->second.visit(call_visitor<TVerb>(), out, args)) {
-        throw std::invalid_argument("unitialized instance");
-      }
-    }
-
     // built-ins
 
     void operator ()(
@@ -345,7 +332,18 @@ private:
 ytse_jam::result_t ytse_jam::handle(std::string const &command, request_args &args) {
   result_t result;
 
-  if (!command_trie::match<>::exact(command.begin(), command.end(), command_parser(), instances_, args, result)) {
+  auto const verb = op_trie::match<>::index(command.begin(), command.end());
+
+  if (verb != op_trie::sequences::size) {
+    auto i = instances_.find(args.next<std::string>());
+    if (i == instances_.end()) { throw std::invalid_argument("instance not found"); }
+    if (i->second.empty()) { throw std::invalid_argument("unitialized instance"); }
+
+    auto const op = op_dispatch::index(i->second.tag(), verb);
+    if (!op_dispatch::visit(op, call_visitor(), i->second, result, args)) {
+      throw std::invalid_argument("invalid operation");
+    }
+  } else if (!command_trie::match<>::exact(command.begin(), command.end(), command_parser(), instances_, args, result)) {
     throw std::invalid_argument("command unknown");
   }
 
@@ -0,0 +1,249 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+/**
+ * Driver for compile-time benchmarks (see `fatal/benchmark/compile_time.h`).
+ *
+ * Compiles each of the given translation units once for each of the given
+ * sizes, and prints the compiler's wall time, CPU time, peak memory and,
+ * for GCC, the number of class and function template specializations it
+ * created.
+ *
+ * Usage:
+ *
+ *  compile_time --sizes=100,1000 \
+ *    fatal/type/benchmark/compile_time/list_sort.cpp \
+ *    fatal/container/benchmark/compile_time/variant.cpp
+ *
+ * Benchmarks are compiled with `-fsyntax-only`, which is where all the time
+ * spent on template metaprogramming goes.
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+
+#include <gflags/gflags.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+DEFINE_string(compiler, "g++", "the compiler to benchmark");
+DEFINE_string(flags, "-std=c++11", "space separated flags for the compiler");
+DEFINE_string(include, ".", "the root directory of fatal");
+DEFINE_string(sizes, "100,500,1000", "comma separated input sizes");
+DEFINE_bool(
+  instantiations, true,
+  "count template specializations using GCC's -fmem-report"
+);
+
+namespace fatal {
+namespace compile_time {
+
+struct result {
+  bool success = false;
+  double wall = 0;
+  double cpu = 0;
+  long peak_kb = 0;
+  long classes = -1;
+  long functions = -1;
+  std::string output;
+};
+
+std::vector<std::string> split(std::string const &s, char separator) {
+  std::vector<std::string> result;
+  std::istringstream in(s);
+
+  for (std::string token; std::getline(in, token, separator); ) {
+    if (!token.empty()) {
+      result.push_back(token);
+    }
+  }
+
+  return result;
+}
+
+// parses `-fmem-report`'s `<table>: size <n>, <elements> elements, ...`
+long parse_elements(std::string const &output, char const *table) {
+  auto const i = output.find(table);
+
+  if (i == std::string::npos) {
+    return -1;
+  }
+
+  auto const comma = output.find(',', i);
+
+  return comma == std::string::npos
+    ? -1
+    : std::strtol(output.c_str() + comma + 1, nullptr, 10);
+}
+
+result compile(std::string const &file, std::string const &size) {
+  std::vector<std::string> args{FLAGS_compiler};
+  for (auto &flag: split(FLAGS_flags, ' ')) {
+    args.push_back(flag);
+  }
+  args.push_back("-fsyntax-only");
+  args.push_back("-I" + FLAGS_include);
+  args.push_back("-DFATAL_COMPILE_TIME_SIZE=" + size);
+  if (FLAGS_instantiations) {
+    args.push_back("-fmem-report");
+  }
+  args.push_back(file);
+
+  std::vector<char *> argv;
+  for (auto &arg: args) {
+    argv.push_back(const_cast<char *>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  result r;
+
+  int pipefd[2];
+  if (pipe(pipefd) != 0) {
+    r.output = std::strerror(errno);
+    return r;
+  }
+
+  auto const start = std::chrono::steady_clock::now();
+  auto const pid = fork();
+
+  if (pid < 0) {
+    r.output = std::strerror(errno);
+    close(pipefd[0]);
+    close(pipefd[1]);
+    return r;
+  }
+
+  if (pid == 0) {
+    dup2(pipefd[1], STDOUT_FILENO);
+    dup2(pipefd[1], STDERR_FILENO);
+    close(pipefd[0]);
+    close(pipefd[1]);
+    execvp(argv.front(), argv.data());
+    std::cerr << "unable to run " << argv.front() << ": "
+      << std::strerror(errno) << std::endl;
+    _exit(127);
+  }
+
+  close(pipefd[1]);
+
+  char buffer[4096];
+  for (ssize_t n; (n = read(pipefd[0], buffer, sizeof(buffer))) != 0; ) {
+    if (n > 0) {
+      r.output.append(buffer, static_cast<std::size_t>(n));
+    } else if (errno != EINTR) {
+      break;
+    }
+  }
+  close(pipefd[0]);
+
+  int status = 0;
+  rusage usage;
+  while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {}
+
+  r.wall = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start
+  ).count();
+  r.cpu = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6
+    + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+  r.peak_kb = usage.ru_maxrss;
+  r.success = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  r.classes = parse_elements(r.output, "type_specializations:");
+  r.functions = parse_elements(r.output, "decl_specializations:");
+
+  return r;
+}
+
+std::string name_of(std::string const &file) {
+  auto const slash = file.find_last_of('/');
+  auto name = slash == std::string::npos ? file : file.substr(slash + 1);
+  auto const dot = name.find_last_of('.');
+  return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+void print_count(long count) {
+  if (count < 0) {
+    std::cout << std::setw(12) << '-';
+  } else {
+    std::cout << std::setw(12) << count;
+  }
+}
+
+int run(std::vector<std::string> const &files) {
+  auto const sizes = split(FLAGS_sizes, ',');
+  int failures = 0;
+
+  std::cout << std::left << std::setw(32) << "benchmark" << std::right
+    << std::setw(8) << "size"
+    << std::setw(10) << "wall (s)"
+    << std::setw(10) << "cpu (s)"
+    << std::setw(12) << "peak (MB)"
+    << std::setw(12) << "classes"
+    << std::setw(12) << "functions"
+    << std::endl;
+
+  for (auto const &file: files) {
+    for (auto const &size: sizes) {
+      auto const r = compile(file, size);
+
+      std::cout << std::left << std::setw(32) << name_of(file) << std::right
+        << std::setw(8) << size;
+
+      if (!r.success) {
+        ++failures;
+        std::cout << "  FAILED" << std::endl << r.output.substr(0, 2048)
+          << std::endl;
+        continue;
+      }
+
+      std::cout << std::fixed << std::setprecision(2)
+        << std::setw(10) << r.wall
+        << std::setw(10) << r.cpu
+        << std::setw(12) << r.peak_kb / 1024;
+      print_count(r.classes);
+      print_count(r.functions);
+      std::cout << std::endl;
+    }
+  }
+
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+} // namespace compile_time {
+} // namespace fatal {
+
+////////////
+// DRIVER //
+////////////
+
+int main(int argc, char **argv) {
+  google::SetUsageMessage("compile_time [flags] benchmark.cpp...");
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (argc < 2) {
+    google::ShowUsageWithFlags(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  return fatal::compile_time::run(
+    std::vector<std::string>(argv + 1, argv + argc)
+  );
+}
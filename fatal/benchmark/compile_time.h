@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#pragma once
+
+#include <fatal/type/list.h>
+
+#include <type_traits>
+
+#include <cstddef>
+
+/**
+ * Support library for compile-time benchmarks.
+ *
+ * A compile-time benchmark is a translation unit that exercises some
+ * metafunction on inputs of `FATAL_COMPILE_TIME_SIZE` elements. It's not
+ * meant to be run, but rather compiled by `fatal/benchmark/compile_time.cpp`,
+ * which records how long the compiler takes, how much memory it needs and
+ * how many templates get instantiated for increasing sizes.
+ *
+ * Example:
+ *
+ *  #include <fatal/benchmark/compile_time.h>
+ *
+ *  namespace fatal {
+ *  namespace compile_time {
+ *
+ *  typedef generate<shuffled>::merge_sort<> result;
+ *  static_assert(result::size == size, "unexpected size");
+ *
+ *  } // namespace compile_time {
+ *  } // namespace fatal {
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+#ifndef FATAL_COMPILE_TIME_SIZE
+# define FATAL_COMPILE_TIME_SIZE 100
+#endif
+
+namespace fatal {
+namespace compile_time {
+
+/**
+ * The amount of elements each benchmark should work with.
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+constexpr std::size_t size = FATAL_COMPILE_TIME_SIZE;
+
+static_assert(size > 0, "FATAL_COMPILE_TIME_SIZE must be positive");
+
+template <std::size_t Value>
+using value = std::integral_constant<std::size_t, Value>;
+
+/**
+ * Generators for the `Index`-th element of an input, for use with `generate`.
+ *
+ *  - `sequential`: yields `Index`;
+ *  - `shuffled`: a permutation of [0, size) (as long as `size` is not a
+ *    multiple of 7919), which is the worst input for sorting algorithms that
+ *    take advantage of already sorted inputs;
+ *  - `repeated`: like `shuffled`, but each value appears about twice.
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <std::size_t Index>
+using sequential = value<Index>;
+
+template <std::size_t Index>
+using shuffled = value<(Index * 7919) % size>;
+
+template <std::size_t Index>
+using repeated = value<(Index * 7919) % (size / 2 + 1)>;
+
+namespace detail {
+
+template <template <std::size_t> class, typename> struct generate;
+
+template <
+  template <std::size_t> class TGenerator,
+  std::size_t... Indexes
+>
+struct generate<
+  TGenerator,
+  ::fatal::detail::type_list_impl::index_pack<Indexes...>
+> {
+  typedef type_list<TGenerator<Indexes>...> type;
+};
+
+} // namespace detail {
+
+/**
+ * A `type_list` whose `Index`-th element is `TGenerator<Index>`, for all
+ * `Index` in [0, Size).
+ *
+ * Built with logarithmic recursion depth, so that generating the input
+ * doesn't get in the way of what's being measured.
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <template <std::size_t> class TGenerator, std::size_t Size = size>
+using generate = typename detail::generate<
+  TGenerator,
+  typename ::fatal::detail::type_list_impl::make_index_pack<Size>::type
+>::type;
+
+} // namespace compile_time {
+} // namespace fatal {
@@ -0,0 +1,340 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#pragma once
+
+#include <fatal/container/flag_set.h>
+
+#include <atomic>
+#include <type_traits>
+
+#include <cstdint>
+
+namespace fatal {
+
+/**
+ * A lock-free counterpart of `flag_set`, whose flags can be concurrently set,
+ * unset and checked by any number of threads.
+ *
+ * Operations on a given list of flags compile down to a single atomic
+ * instruction (`fetch_or`, `fetch_and`, `load`, `store` or `exchange`) using
+ * a mask computed at compile time. Whole sets can also be atomically swapped
+ * or compared and exchanged.
+ *
+ * Every operation takes an optional memory ordering, which defaults to
+ * `std::memory_order_seq_cst`, just like `std::atomic`.
+ *
+ * Only sets that fit in a single integral are supported, that is, up to 63
+ * flags.
+ *
+ * Assume, in the examples below, that these types are available:
+ *
+ *  struct my_flag_1 {};
+ *  struct my_flag_2 {};
+ *  struct my_flag_3 {};
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <typename... TFlags>
+class atomic_flag_set {
+public:
+  /**
+   * The non-atomic `flag_set` with the same flags, used to read or write the
+   * whole set at once.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  typedef flag_set<TFlags...> set_type;
+
+  /**
+   * The list of supported flags.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  typedef typename set_type::tag_list tag_list;
+
+  /**
+   * The integral representation of the set, as in `flag_set`.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  typedef typename set_type::flags_type flags_type;
+
+  static_assert(
+    std::is_integral<flags_type>::value,
+    "too many flags for a lock-free atomic_flag_set"
+  );
+
+private:
+  typedef detail::flag_set_impl::storage<tag_list::size> storage;
+
+  // `std::atomic<bool>` has no bitwise operations
+  typedef typename std::conditional<
+    std::is_same<flags_type, bool>::value, std::uint_fast8_t, flags_type
+  >::type word_type;
+
+  template <typename... UFlags>
+  using mask_for = std::integral_constant<
+    word_type,
+    storage::template mask<
+      std::integral_constant<
+        typename std::enable_if<
+          tag_list::template contains<UFlags>::value,
+          std::size_t
+        >::type,
+        tag_list::template index_of<UFlags>::value
+      >::value...
+    >::value
+  >;
+
+  static set_type to_set(word_type flags) {
+    return set_type::from_integral(static_cast<flags_type>(flags));
+  }
+
+  static word_type from_set(set_type const &flags) {
+    return static_cast<word_type>(flags.get());
+  }
+
+public:
+  /**
+   * Default constructor that starts with all flags unset.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  atomic_flag_set(): flags_(0) {}
+
+  /**
+   * Constructor that starts with exactly what's set in `flags`.
+   *
+   * Example:
+   *
+   *  atomic_flag_set<my_flag_1, my_flag_2, my_flag_3> s(
+   *    flag_set<my_flag_1, my_flag_2, my_flag_3>{my_flag_2()}
+   *  );
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  explicit atomic_flag_set(set_type const &flags): flags_(from_set(flags)) {}
+
+  atomic_flag_set(atomic_flag_set const &) = delete;
+  atomic_flag_set &operator =(atomic_flag_set const &) = delete;
+
+  /**
+   * Tells whether the operations are lock-free, which is always the case on
+   * mainstream platforms.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  bool is_lock_free() const { return flags_.is_lock_free(); }
+
+  /**
+   * Atomically reads the whole set.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  set_type load(std::memory_order order = std::memory_order_seq_cst) const {
+    return to_set(flags_.load(order));
+  }
+
+  /**
+   * Atomically replaces the whole set with `flags`.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  void store(
+    set_type const &flags,
+    std::memory_order order = std::memory_order_seq_cst
+  ) {
+    flags_.store(from_set(flags), order);
+  }
+
+  /**
+   * Atomically replaces the whole set with `flags`, returning the previous
+   * one.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  set_type exchange(
+    set_type const &flags,
+    std::memory_order order = std::memory_order_seq_cst
+  ) {
+    return to_set(flags_.exchange(from_set(flags), order));
+  }
+
+  /**
+   * Atomically replaces the whole set with `desired` as long as it currently
+   * equals `expected`. Otherwise, `expected` receives the current set.
+   *
+   * Returns `true` when the set was replaced, `false` otherwise.
+   *
+   * As with `std::atomic`, this may fail spuriously, so it's meant to be used
+   * in a loop. Refer to `compare_exchange_strong` otherwise.
+   *
+   * Example:
+   *
+   *  atomic_flag_set<my_flag_1, my_flag_2, my_flag_3> s;
+   *
+   *  // atomically toggles `my_flag_1` and `my_flag_2`
+   *  auto expected = s.load(std::memory_order_relaxed);
+   *  decltype(expected) const toggle{my_flag_1(), my_flag_2()};
+   *  while (!s.compare_exchange_weak(expected, expected ^ toggle)) {}
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  bool compare_exchange_weak(
+    set_type &expected,
+    set_type const &desired,
+    std::memory_order success = std::memory_order_seq_cst,
+    std::memory_order failure = std::memory_order_seq_cst
+  ) {
+    auto current = from_set(expected);
+    auto const result = flags_.compare_exchange_weak(
+      current, from_set(desired), success, failure
+    );
+    expected = to_set(current);
+    return result;
+  }
+
+  /**
+   * Same as `compare_exchange_weak` but never fails spuriously.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  bool compare_exchange_strong(
+    set_type &expected,
+    set_type const &desired,
+    std::memory_order success = std::memory_order_seq_cst,
+    std::memory_order failure = std::memory_order_seq_cst
+  ) {
+    auto current = from_set(expected);
+    auto const result = flags_.compare_exchange_strong(
+      current, from_set(desired), success, failure
+    );
+    expected = to_set(current);
+    return result;
+  }
+
+  /**
+   * Atomically sets the given flags, leaving the other ones unchanged.
+   *
+   * Example:
+   *
+   *  atomic_flag_set<my_flag_1, my_flag_2, my_flag_3> s;
+   *
+   *  // sets `my_flag_1` and `my_flag_2`
+   *  s.set<my_flag_1, my_flag_2>();
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename... UFlags>
+  void set(std::memory_order order = std::memory_order_seq_cst) {
+    flags_.fetch_or(mask_for<UFlags...>::value, order);
+  }
+
+  /**
+   * Atomically unsets the given flags, leaving the other ones unchanged.
+   *
+   * Example:
+   *
+   *  atomic_flag_set<my_flag_1, my_flag_2, my_flag_3> s;
+   *
+   *  // unsets `my_flag_1` and `my_flag_2`
+   *  s.unset<my_flag_1, my_flag_2>();
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename... UFlags>
+  void unset(std::memory_order order = std::memory_order_seq_cst) {
+    flags_.fetch_and(
+      static_cast<word_type>(~mask_for<UFlags...>::value),
+      order
+    );
+  }
+
+  /**
+   * Atomically resets this set to contain exactly the given flags.
+   *
+   * Just like `flag_set::reset`, this is the same as calling `clear()` then
+   * `set<UFlags...>()`, except that it happens in a single step.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename... UFlags>
+  void reset(std::memory_order order = std::memory_order_seq_cst) {
+    flags_.store(mask_for<UFlags...>::value, order);
+  }
+
+  /**
+   * Atomically unsets all the flags.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  void clear(std::memory_order order = std::memory_order_seq_cst) {
+    flags_.store(0, order);
+  }
+
+  /**
+   * Tells whether all given flags are set.
+   *
+   * Example:
+   *
+   *  atomic_flag_set<my_flag_1, my_flag_2, my_flag_3> s;
+   *
+   *  // yields `false`
+   *  s.is_set<my_flag_1>(std::memory_order_acquire);
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename... UFlags>
+  bool is_set(std::memory_order order = std::memory_order_seq_cst) const {
+    typedef mask_for<UFlags...> mask;
+    return (flags_.load(order) & mask::value) == mask::value;
+  }
+
+  /**
+   * Atomically sets the given flags, and tells whether all of them were
+   * already set beforehand.
+   *
+   * Example:
+   *
+   *  atomic_flag_set<my_flag_1, my_flag_2, my_flag_3> s;
+   *
+   *  // only the first thread to get here will see `false`
+   *  if (!s.test_and_set<my_flag_1>()) {
+   *    // ...
+   *  }
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename... UFlags>
+  bool test_and_set(std::memory_order order = std::memory_order_seq_cst) {
+    typedef mask_for<UFlags...> mask;
+    return (flags_.fetch_or(mask::value, order) & mask::value) == mask::value;
+  }
+
+  /**
+   * Atomically unsets the given flags, and tells whether all of them were
+   * set beforehand.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename... UFlags>
+  bool test_and_unset(std::memory_order order = std::memory_order_seq_cst) {
+    typedef mask_for<UFlags...> mask;
+    return (
+      flags_.fetch_and(static_cast<word_type>(~mask::value), order)
+        & mask::value
+    ) == mask::value;
+  }
+
+private:
+  std::atomic<word_type> flags_;
+};
+
+} // namespace fatal {
@@ -0,0 +1,39 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/benchmark/compile_time.h>
+
+#include <fatal/container/variant.h>
+
+namespace fatal {
+namespace compile_time {
+
+typedef generate<sequential>::apply<auto_variant> var;
+
+struct visitor {
+  template <std::size_t Value>
+  void operator ()(value<Value>, std::size_t &out) const { out = Value; }
+};
+
+// instantiates the most commonly used members
+std::size_t use(var &v) {
+  std::size_t result = 0;
+
+  v.set(value<size / 2>());
+  v.visit(visitor(), result);
+
+  var copy(v);
+  v = std::move(copy);
+
+  return result + v.tag() + v.type().hash_code()
+    + v.is_of<value<size - 1>>();
+}
+
+} // namespace compile_time {
+} // namespace fatal {
@@ -0,0 +1,206 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#pragma once
+
+#include <fatal/type/enum.h>
+
+#include <array>
+#include <cassert>
+#include <stdexcept>
+#include <type_traits>
+
+namespace fatal {
+
+/**
+ * A fixed size container with one element of type `T` for each field of the
+ * rich enum `Enum` (see `FATAL_RICH_ENUM`).
+ *
+ * Elements are stored in a flat array, in the declaration order of the enum's
+ * fields, regardless of how sparse the enum values are. Looking an element up
+ * is a matter of mapping the enum value to its position in the declaration
+ * order, which is done at compile time when the value is known, and by the
+ * enum's `index_of()` otherwise.
+ *
+ * Assume, in the examples below, that this enum is available:
+ *
+ *  #define ENUMIFY_MY_ENUM(F, M, L, ...) \
+ *    F(field0, __VA_ARGS__) \
+ *    M(field1, 17, __VA_ARGS__) \
+ *    L(field2, 101, __VA_ARGS__)
+ *  FATAL_RICH_ENUM(my_enum, my_enum_str, ENUMIFY_MY_ENUM);
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <typename Enum, typename T>
+class enum_array {
+  typedef enum_str_class<Enum> str;
+  typedef typename str::values values;
+
+  typedef std::array<T, values::size> container_type;
+
+public:
+  typedef Enum key_type;
+  typedef T value_type;
+
+  typedef typename container_type::size_type size_type;
+  typedef typename container_type::reference reference;
+  typedef typename container_type::const_reference const_reference;
+  typedef typename container_type::iterator iterator;
+  typedef typename container_type::const_iterator const_iterator;
+
+  /**
+   * Default constructor that value-initializes all elements.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  enum_array(): data_() {}
+
+  /**
+   * Constructor that initializes all elements with `value`.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  explicit enum_array(T const &value) { data_.fill(value); }
+
+  /**
+   * The amount of elements, which equals the amount of fields in the enum.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  static constexpr size_type size() { return values::size; }
+
+  /**
+   * The position, in the flat array, of the element for `key`, or `size()`
+   * if `key` is not a valid value for the enum.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  static size_type index_of(Enum key) { return str::index_of(key); }
+
+  /**
+   * The key of the element at position `index` of the flat array.
+   *
+   * Example:
+   *
+   *  // yields `my_enum::field1`
+   *  enum_array<my_enum, int>::key(1);
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  static Enum key(size_type index) {
+    assert(index < size());
+    return values::template typed_apply<
+      detail::enum_impl::value_table
+    >::data[index];
+  }
+
+  /**
+   * Accesses the element for the compile-time key `Key`, whose position is
+   * computed at compile time.
+   *
+   * Example:
+   *
+   *  enum_array<my_enum, int> a;
+   *
+   *  a.get<my_enum::field2>() = 10;
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <Enum Key>
+  reference get() { return std::get<position<Key>::value>(data_); }
+
+  template <Enum Key>
+  const_reference get() const {
+    return std::get<position<Key>::value>(data_);
+  }
+
+  /**
+   * Accesses the element for `key`, which must be a valid value for the enum.
+   *
+   * Example:
+   *
+   *  enum_array<my_enum, int> a;
+   *
+   *  ++a[my_enum::field1];
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  reference operator [](Enum key) {
+    assert(index_of(key) < size());
+    return data_[index_of(key)];
+  }
+
+  const_reference operator [](Enum key) const {
+    assert(index_of(key) < size());
+    return data_[index_of(key)];
+  }
+
+  /**
+   * Accesses the element for `key`, throwing `std::out_of_range` when `key`
+   * is not a valid value for the enum.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  reference at(Enum key) { return data_[checked_index(key)]; }
+  const_reference at(Enum key) const { return data_[checked_index(key)]; }
+
+  /**
+   * Sets all elements to `value`.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  void fill(T const &value) { data_.fill(value); }
+
+  /**
+   * The underlying flat array, in the declaration order of the enum's fields.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  T *data() { return data_.data(); }
+  T const *data() const { return data_.data(); }
+
+  /**
+   * Iterators over the elements, in the declaration order of the enum's
+   * fields. The key of the element an iterator `i` points to is given by
+   * `key(i - begin())`.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  iterator begin() { return data_.begin(); }
+  const_iterator begin() const { return data_.begin(); }
+  const_iterator cbegin() const { return data_.cbegin(); }
+
+  iterator end() { return data_.end(); }
+  const_iterator end() const { return data_.end(); }
+  const_iterator cend() const { return data_.cend(); }
+
+  bool operator ==(enum_array const &rhs) const { return data_ == rhs.data_; }
+  bool operator !=(enum_array const &rhs) const { return data_ != rhs.data_; }
+
+private:
+  template <Enum Key>
+  using position = typename values::list::template index_of<
+    std::integral_constant<Enum, Key>
+  >;
+
+  static size_type checked_index(Enum key) {
+    auto const index = index_of(key);
+
+    if (index >= size()) {
+      throw std::out_of_range("invalid enum value");
+    }
+
+    return index;
+  }
+
+  container_type data_;
+};
+
+} // namespace fatal {
@@ -13,12 +13,432 @@
 #include <fatal/type/list.h>
 #include <fatal/type/traits.h>
 
+#include <array>
 #include <type_traits>
 
 #include <cassert>
+#include <cstdint>
 
 namespace fatal {
 
+////////////////////////////
+// IMPLEMENTATION DETAILS //
+////////////////////////////
+
+namespace detail {
+namespace flag_set_impl {
+
+// counts the bits set with the usual bit twiddling, which compilers turn into
+// a single instruction where one is available
+constexpr std::size_t pop_count_bytes(std::uint64_t word) {
+  return static_cast<std::size_t>(
+    (((word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full) * 0x0101010101010101ull)
+      >> 56
+  );
+}
+
+constexpr std::size_t pop_count_nibbles(std::uint64_t word) {
+  return pop_count_bytes(
+    (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull)
+  );
+}
+
+constexpr std::size_t pop_count(std::uint64_t word) {
+  return pop_count_nibbles(word - ((word >> 1) & 0x5555555555555555ull));
+}
+
+// flags that fit in a single integral - indexes past the end, standing for
+// unsupported flags, are ignored
+template <std::size_t Size, bool = (Size < data_bits<std::uint64_t>::value)>
+struct storage {
+  typedef smallest_fast_unsigned_integral<Size> type;
+
+  typedef mersenne_number<Size> range_mask;
+
+  template <std::size_t... Indexes>
+  using mask = bitwise_or_constants<
+    std::integral_constant<type, 0>,
+    std::integral_constant<
+      type, (Indexes < Size ? (type(1) << Indexes) : 0)
+    >...
+  >;
+
+  template <std::size_t... Indexes>
+  static void set(type &flags) { flags |= mask<Indexes...>::value; }
+
+  template <std::size_t... Indexes>
+  static void assign(type &flags) { flags = mask<Indexes...>::value; }
+
+  template <std::size_t... Indexes>
+  static bool test(type flags) {
+    return (flags & mask<Indexes...>::value) == mask<Indexes...>::value;
+  }
+
+  static void clear(type &flags) { flags = 0; }
+
+  static bool valid(type flags) {
+    return (flags & range_mask::value) == flags;
+  }
+
+  static void bitwise_and(type &lhs, type rhs) { lhs &= rhs; }
+  static void bitwise_or(type &lhs, type rhs) { lhs |= rhs; }
+  static void bitwise_xor(type &lhs, type rhs) { lhs ^= rhs; }
+
+  static bool equal(type lhs, type rhs) { return lhs == rhs; }
+
+  static std::size_t count(type flags) { return pop_count(flags); }
+
+  static bool any(type flags) { return flags != 0; }
+  static bool all(type flags) { return flags == range_mask::value; }
+
+  static void set_at(type &flags, std::size_t index) {
+    assert(index < Size);
+    flags |= static_cast<type>(type(1) << index);
+  }
+
+  static bool test_at(type flags, std::size_t index) {
+    assert(index < Size);
+    return (flags >> index) & 1;
+  }
+
+  static std::uint64_t word(type flags, std::size_t) { return flags; }
+
+  static void merge(type &flags, std::size_t, std::uint64_t bits) {
+    flags |= static_cast<type>(bits);
+  }
+};
+
+// flags spread across an array of words - single flags are still resolved to
+// a word and a mask at compile time, while whole set operations are plain
+// loops over the words which compilers are able to vectorize
+template <std::size_t Size>
+struct storage<Size, false> {
+  typedef std::uint64_t word_type;
+
+  static constexpr std::size_t word_bits = data_bits<word_type>::value;
+  static constexpr std::size_t words = (Size + word_bits - 1) / word_bits;
+
+  typedef std::array<word_type, words> type;
+
+  // the bits of the last word that stand for a flag
+  static constexpr word_type last_mask = Size % word_bits
+    ? (word_type(1) << (Size % word_bits)) - 1
+    : ~word_type(0);
+
+  template <std::size_t Index>
+  using word_for = std::integral_constant<
+    std::size_t, (Index < Size ? Index / word_bits : 0)
+  >;
+
+  template <std::size_t Index>
+  using bit_for = std::integral_constant<
+    word_type, (Index < Size ? word_type(1) << (Index % word_bits) : 0)
+  >;
+
+  template <std::size_t... Indexes>
+  static void set(type &flags) {
+    bool const expand[] = {
+      false,
+      (flags[word_for<Indexes>::value] |= bit_for<Indexes>::value, false)...
+    };
+    (void) expand;
+  }
+
+  template <std::size_t... Indexes>
+  static void assign(type &flags) {
+    clear(flags);
+    set<Indexes...>(flags);
+  }
+
+  template <std::size_t... Indexes>
+  static bool test(type const &flags) {
+    bool const results[] = {
+      true, (flags[word_for<Indexes>::value] & bit_for<Indexes>::value) != 0 ...
+    };
+
+    for (auto result: results) {
+      if (!result) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  static void clear(type &flags) { flags.fill(0); }
+
+  static bool valid(type const &flags) {
+    return (flags[words - 1] & ~last_mask) == 0;
+  }
+
+  static void bitwise_and(type &lhs, type const &rhs) {
+    for (std::size_t i = 0; i < words; ++i) {
+      lhs[i] &= rhs[i];
+    }
+  }
+
+  static void bitwise_or(type &lhs, type const &rhs) {
+    for (std::size_t i = 0; i < words; ++i) {
+      lhs[i] |= rhs[i];
+    }
+  }
+
+  static void bitwise_xor(type &lhs, type const &rhs) {
+    for (std::size_t i = 0; i < words; ++i) {
+      lhs[i] ^= rhs[i];
+    }
+  }
+
+  // accumulates the differences instead of stopping at the first one, so
+  // that there's no branch in the loop
+  static bool equal(type const &lhs, type const &rhs) {
+    word_type difference = 0;
+
+    for (std::size_t i = 0; i < words; ++i) {
+      difference |= lhs[i] ^ rhs[i];
+    }
+
+    return difference == 0;
+  }
+
+  static std::size_t count(type const &flags) {
+    std::size_t result = 0;
+
+    for (std::size_t i = 0; i < words; ++i) {
+      result += pop_count(flags[i]);
+    }
+
+    return result;
+  }
+
+  static bool any(type const &flags) {
+    word_type result = 0;
+
+    for (std::size_t i = 0; i < words; ++i) {
+      result |= flags[i];
+    }
+
+    return result != 0;
+  }
+
+  static bool all(type const &flags) {
+    word_type missing = ~flags[words - 1] & last_mask;
+
+    for (std::size_t i = 0; i < words - 1; ++i) {
+      missing |= ~flags[i];
+    }
+
+    return missing == 0;
+  }
+
+  static void set_at(type &flags, std::size_t index) {
+    assert(index < Size);
+    flags[index / word_bits] |= word_type(1) << (index % word_bits);
+  }
+
+  static bool test_at(type const &flags, std::size_t index) {
+    assert(index < Size);
+    return (flags[index / word_bits] >> (index % word_bits)) & 1;
+  }
+
+  static word_type word(type const &flags, std::size_t index) {
+    return flags[index];
+  }
+
+  static void merge(type &flags, std::size_t index, word_type bits) {
+    flags[index] |= bits;
+  }
+};
+
+template <std::size_t Size>
+constexpr std::size_t storage<Size, false>::word_bits;
+
+template <std::size_t Size>
+constexpr std::size_t storage<Size, false>::words;
+
+template <std::size_t Size>
+constexpr typename storage<Size, false>::word_type
+  storage<Size, false>::last_mask;
+
+// where each flag of a foreign set goes in the local one, as seen by the
+// words of both integral representations
+template <
+  typename TFrom, typename TTo,
+  typename = typename type_list_impl::make_index_pack<TFrom::size>::type
+>
+struct permutation_keys;
+
+template <typename... UFlags, typename TTo, std::size_t... Indexes>
+struct permutation_keys<
+  type_list<UFlags...>, TTo, type_list_impl::index_pack<Indexes...>
+> {
+  static constexpr std::size_t size = sizeof...(UFlags);
+  static constexpr std::size_t word_bits = data_bits<std::uint64_t>::value;
+
+  // the local index of each foreign flag, or `TTo::size` if unsupported
+  static constexpr std::size_t target[sizeof...(UFlags) + 1] = {
+    TTo::template index_of<UFlags>::value..., TTo::size
+  };
+
+  static constexpr bool supported(std::size_t index) {
+    return target[index] < TTo::size;
+  }
+
+  static constexpr std::size_t from_word(std::size_t index) {
+    return index / word_bits;
+  }
+
+  static constexpr std::size_t to_word(std::size_t index) {
+    return target[index] / word_bits;
+  }
+
+  static constexpr std::ptrdiff_t shift(std::size_t index) {
+    return static_cast<std::ptrdiff_t>(target[index] % word_bits)
+      - static_cast<std::ptrdiff_t>(index % word_bits);
+  }
+
+  // flags moving from the same word to the same word by the same distance
+  // can be moved together with a single mask and shift
+  static constexpr bool same(std::size_t lhs, std::size_t rhs) {
+    return supported(lhs) && supported(rhs)
+      && from_word(lhs) == from_word(rhs)
+      && to_word(lhs) == to_word(rhs)
+      && shift(lhs) == shift(rhs);
+  }
+
+  // whether any flag in `[begin, end)` moves along with the one at `index`
+  static constexpr bool repeated(
+    std::size_t index, std::size_t begin, std::size_t end
+  ) {
+    return end - begin < 2
+      ? begin < end && same(index, begin)
+      : repeated(index, begin, begin + (end - begin) / 2)
+        || repeated(index, begin + (end - begin) / 2, end);
+  }
+
+  // the bits of the flags in `[begin, end)` moving along with the one at
+  // `index`, as seen in the foreign word
+  static constexpr std::uint64_t mask(
+    std::size_t index, std::size_t begin, std::size_t end
+  ) {
+    return end - begin < 2
+      ? (begin < end && same(index, begin)
+        ? std::uint64_t(1) << (begin % word_bits)
+        : 0
+      )
+      : mask(index, begin, begin + (end - begin) / 2)
+        | mask(index, begin + (end - begin) / 2, end);
+  }
+};
+
+template <typename... UFlags, typename TTo, std::size_t... Indexes>
+constexpr std::size_t permutation_keys<
+  type_list<UFlags...>, TTo, type_list_impl::index_pack<Indexes...>
+>::target[sizeof...(UFlags) + 1];
+
+// the first flag of each group of flags moving together leads the group
+template <
+  typename TKeys,
+  typename = typename type_list_impl::make_index_pack<TKeys::size>::type
+>
+struct permutation_leaders;
+
+template <typename TKeys, std::size_t... Indexes>
+struct permutation_leaders<TKeys, type_list_impl::index_pack<Indexes...>> {
+  static constexpr bool leader[sizeof...(Indexes) + 1] = {
+    (TKeys::supported(Indexes) && !TKeys::repeated(Indexes, 0, Indexes))...,
+    false
+  };
+
+  static constexpr std::size_t count(std::size_t begin, std::size_t end) {
+    return end - begin < 2
+      ? begin < end && leader[begin]
+      : count(begin, begin + (end - begin) / 2)
+        + count(begin + (end - begin) / 2, end);
+  }
+
+  // the index of the `nth` leader in `[begin, end)`
+  static constexpr std::size_t find(
+    std::size_t nth, std::size_t begin, std::size_t end
+  ) {
+    return end - begin < 2
+      ? begin
+      : nth < count(begin, begin + (end - begin) / 2)
+        ? find(nth, begin, begin + (end - begin) / 2)
+        : find(
+          nth - count(begin, begin + (end - begin) / 2),
+          begin + (end - begin) / 2,
+          end
+        );
+  }
+};
+
+template <typename TKeys, std::size_t... Indexes>
+constexpr bool permutation_leaders<
+  TKeys, type_list_impl::index_pack<Indexes...>
+>::leader[sizeof...(Indexes) + 1];
+
+inline std::uint64_t shift_word(std::uint64_t word, std::ptrdiff_t shift) {
+  return shift < 0 ? word >> -shift : word << shift;
+}
+
+// a group of flags moving together, as computed at compile time
+template <
+  std::size_t FromWord, std::size_t ToWord,
+  std::ptrdiff_t Shift, std::uint64_t Mask
+>
+struct permutation_group {
+  template <typename TFrom, typename TTo>
+  static bool apply(
+    typename TFrom::type const &from, typename TTo::type &to
+  ) {
+    TTo::merge(
+      to, ToWord, shift_word(TFrom::word(from, FromWord) & Mask, Shift)
+    );
+    return true;
+  }
+};
+
+template <
+  typename TKeys,
+  typename TLeaders = permutation_leaders<TKeys>,
+  typename = typename type_list_impl::make_index_pack<
+    TLeaders::count(0, TKeys::size)
+  >::type
+>
+struct permutation;
+
+// moves the flags of a foreign set into their places in the local one, one
+// group of flags at a time, rather than one flag at a time
+template <typename TKeys, typename TLeaders, std::size_t... Groups>
+struct permutation<TKeys, TLeaders, type_list_impl::index_pack<Groups...>> {
+  static constexpr std::size_t groups = sizeof...(Groups);
+
+  template <typename TFrom, typename TTo>
+  static void apply(
+    typename TFrom::type const &from, typename TTo::type &to
+  ) {
+    bool const expand[] = {
+      false,
+      permutation_group<
+        TKeys::from_word(TLeaders::find(Groups, 0, TKeys::size)),
+        TKeys::to_word(TLeaders::find(Groups, 0, TKeys::size)),
+        TKeys::shift(TLeaders::find(Groups, 0, TKeys::size)),
+        TKeys::mask(TLeaders::find(Groups, 0, TKeys::size), 0, TKeys::size)
+      >::template apply<TFrom, TTo>(from, to)...
+    };
+    (void) expand;
+  }
+};
+
+template <typename TKeys, typename TLeaders, std::size_t... Groups>
+constexpr std::size_t permutation<
+  TKeys, TLeaders, type_list_impl::index_pack<Groups...>
+>::groups;
+
+} // namespace flag_set_impl {
+} // namespace detail {
+
 /**
  * A type-safe way to represent a set of boolean flags.
  *
@@ -40,17 +460,20 @@ struct flag_set {
    */
   typedef type_list<TFlags...> tag_list;
 
+private:
+  typedef detail::flag_set_impl::storage<tag_list::size> storage;
+
+public:
   /**
    * The integral representation of the flag_set.
    *
+   * Up to 63 flags, this is the smallest fast unsigned integral that can hold
+   * all of them. Otherwise, it's an array of 64 bits unsigned integrals, where
+   * the flag at index `i` is the bit `i % 64` of the word `i / 64`.
+   *
    * @author: Marcelo Juchem <marcelo@fb.com>
    */
-  typedef smallest_fast_unsigned_integral<tag_list::size> flags_type;
-
-  static_assert(
-    tag_list::size <= data_bits<flags_type>::value,
-    "too many flags"
-  );
+  typedef typename storage::type flags_type;
 
   static_assert(
     logical_and_constants<
@@ -61,44 +484,36 @@ struct flag_set {
   );
 
 private:
-  typedef mersenne_number<tag_list::size> range_mask;
-
-  template <bool IgnoreUnsupported, typename... UFlags>
-  using mask_for = bitwise_or_constants<
-    std::integral_constant<flags_type, 0>,
-    std::integral_constant<
-      typename std::enable_if<
-        IgnoreUnsupported || tag_list::template contains<UFlags>::value,
-        flags_type
-      >::type,
-      (tag_list::template index_of<UFlags>::value < tag_list::size
-        ? (flags_type(1) << tag_list::template index_of<UFlags>::value)
-        : 0
-      )
-    >...
+  // the index of the given flag, or `tag_list::size` if it's not supported
+  template <typename UFlag, bool IgnoreUnsupported = false>
+  using index_for = std::integral_constant<
+    typename std::enable_if<
+      IgnoreUnsupported || tag_list::template contains<UFlag>::value,
+      std::size_t
+    >::type,
+    tag_list::template index_of<UFlag>::value
   >;
 
+  // the permutation between the foreign flags and the local ones is computed
+  // at compile time, so that flags are moved in groups with a single mask and
+  // shift, instead of one at a time
   template <typename... UFlags>
   struct import_foreign {
     typedef flag_set<UFlags...> foreign_set;
 
-    struct visitor {
-      template <typename UFlag, std::size_t Index>
-      void operator ()(
-        indexed_type_tag<UFlag, Index>,
-        foreign_set const &foreign,
-        flags_type &out
-      ) {
-        if (foreign.template is_set<UFlag>()) {
-          out |= mask_for<true, UFlag>::value;
-        }
-      }
-    };
+    typedef detail::flag_set_impl::permutation<
+      detail::flag_set_impl::permutation_keys<
+        typename foreign_set::tag_list, tag_list
+      >
+    > permutation;
 
     static flags_type import(foreign_set const &foreign) {
-      flags_type flags(0);
-      foreign_set::tag_list::foreach(visitor(), foreign, flags);
-      assert((flags & range_mask::value) == flags);
+      flags_type flags{};
+      permutation::template apply<
+        detail::flag_set_impl::storage<foreign_set::tag_list::size>,
+        storage
+      >(foreign.get(), flags);
+      assert(storage::valid(flags));
       return flags;
     }
   };
@@ -109,7 +524,7 @@ public:
    *
    * @author: Marcelo Juchem <marcelo@fb.com>
    */
-  flag_set(): flags_(0) {}
+  flag_set(): flags_() {}
 
   flag_set(flag_set const &) = default;
   flag_set(flag_set &&) = default;
@@ -128,16 +543,18 @@ public:
     typename... UFlags,
     typename X = safe_ctor_overload_t<flag_set, UFlags...>
   >
-  explicit flag_set(UFlags &&...):
-    flags_(mask_for<false, typename std::decay<UFlags>::type...>::value)
-  {}
+  explicit flag_set(UFlags &&...): flags_() {
+    storage::template assign<
+      index_for<typename std::decay<UFlags>::type>::value...
+    >(flags_);
+  }
 
   /**
    * Unsets all the flags in this `flag_set`.
    *
    * @author: Marcelo Juchem <marcelo@fb.com>
    */
-  void clear() { flags_ = 0; }
+  void clear() { storage::clear(flags_); }
 
   /**
    * Initializes this set setting all supported flags that are set in `other`,
@@ -207,8 +624,8 @@ public:
    */
   template <typename... UFlags>
   flag_set &set() & {
-    flags_ |= mask_for<false, UFlags...>::value;
-    assert((flags_ & range_mask::value) == flags_);
+    storage::template set<index_for<UFlags>::value...>(flags_);
+    assert(storage::valid(flags_));
     return *this;
   }
 
@@ -225,8 +642,8 @@ public:
    */
   template <typename... UFlags>
   flag_set &&set() && {
-    flags_ |= mask_for<false, UFlags...>::value;
-    assert((flags_ & range_mask::value) == flags_);
+    storage::template set<index_for<UFlags>::value...>(flags_);
+    assert(storage::valid(flags_));
     return std::move(*this);
   }
 
@@ -315,8 +732,8 @@ public:
    */
   template <typename... UFlags>
   void reset() {
-    flags_ = mask_for<false, UFlags...>::value;
-    assert((flags_ & range_mask::value) == flags_);
+    storage::template assign<index_for<UFlags>::value...>(flags_);
+    assert(storage::valid(flags_));
   }
 
   /**
@@ -368,8 +785,43 @@ public:
    */
   template <typename... UFlags>
   bool is_set() const {
-    typedef mask_for<false, UFlags...> mask;
-    return (flags_ & mask::value) == mask::value;
+    return storage::template test<index_for<UFlags>::value...>(flags_);
+  }
+
+  /**
+   * Sets the flag at position `index` of `tag_list`, for when the flag is
+   * only known at runtime. `index` must be less than `tag_list::size`.
+   *
+   * Example:
+   *
+   *  flag_set<my_flag_1, my_flag_2, my_flag_3> s;
+   *
+   *  // sets `my_flag_2`
+   *  s.set_at(1);
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  flag_set &set_at(std::size_t index) {
+    storage::set_at(flags_, index);
+    return *this;
+  }
+
+  /**
+   * Tells whether the flag at position `index` of `tag_list` is set, for when
+   * the flag is only known at runtime. `index` must be less than
+   * `tag_list::size`.
+   *
+   * Example:
+   *
+   *  flag_set<my_flag_1, my_flag_2, my_flag_3> s{my_flag_2()};
+   *
+   *  // yields `true`
+   *  s.is_set_at(1);
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  bool is_set_at(std::size_t index) const {
+    return storage::test_at(flags_, index);
   }
 
   /**
@@ -494,6 +946,24 @@ public:
    */
   fast_pass<flags_type> get() const { return flags_; }
 
+  /**
+   * Builds a `flag_set` out of its integral representation, as returned by
+   * `get()`.
+   *
+   * Example:
+   *
+   *  // yields a set with `my_flag_1` and `my_flag_3` set
+   *  flag_set<my_flag_1, my_flag_2, my_flag_3>::from_integral(0b101);
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  static flag_set from_integral(fast_pass<flags_type> flags) {
+    flag_set result;
+    result.flags_ = flags;
+    assert(storage::valid(result.flags_));
+    return result;
+  }
+
   /**
    * Assignment operator. Sets this `flag_set` with exactly what's set in `rhs`.
    *
@@ -501,7 +971,7 @@ public:
    */
   flag_set &operator =(flag_set const &rhs) {
     flags_ = rhs.flags_;
-    assert((flags_ & range_mask::value) == flags_);
+    assert(storage::valid(flags_));
 
     return *this;
   }
@@ -518,6 +988,126 @@ public:
     return *this;
   }
 
+  /**
+   * Returns how many flags are set.
+   *
+   * Example:
+   *
+   *  // yields `2`
+   *  flag_set<my_flag_1, my_flag_2, my_flag_3>{my_flag_1(), my_flag_3()}
+   *    .count();
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  std::size_t count() const { return storage::count(flags_); }
+
+  /**
+   * Tells whether at least one flag is set.
+   *
+   * Example:
+   *
+   *  // yields `true`
+   *  flag_set<my_flag_1, my_flag_2>{my_flag_2()}.any();
+   *
+   *  // yields `false`
+   *  flag_set<my_flag_1, my_flag_2>().any();
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  bool any() const { return storage::any(flags_); }
+
+  /**
+   * Tells whether all supported flags are set.
+   *
+   * Example:
+   *
+   *  // yields `true`
+   *  flag_set<my_flag_1, my_flag_2>{my_flag_1(), my_flag_2()}.all();
+   *
+   *  // yields `false`
+   *  flag_set<my_flag_1, my_flag_2>{my_flag_2()}.all();
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  bool all() const { return storage::all(flags_); }
+
+  /**
+   * Keeps set only the flags that are also set in `rhs`.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  flag_set &operator &=(flag_set const &rhs) {
+    storage::bitwise_and(flags_, rhs.flags_);
+    return *this;
+  }
+
+  /**
+   * Also sets the flags that are set in `rhs`.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  flag_set &operator |=(flag_set const &rhs) {
+    storage::bitwise_or(flags_, rhs.flags_);
+    return *this;
+  }
+
+  /**
+   * Toggles the flags that are set in `rhs`.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  flag_set &operator ^=(flag_set const &rhs) {
+    storage::bitwise_xor(flags_, rhs.flags_);
+    return *this;
+  }
+
+  /**
+   * Returns a set with the flags that are set in both this set and `rhs`.
+   *
+   * Example:
+   *
+   *  flag_set<my_flag_1, my_flag_2, my_flag_3> s{my_flag_1(), my_flag_3()};
+   *  flag_set<my_flag_1, my_flag_2, my_flag_3> r{my_flag_2(), my_flag_3()};
+   *
+   *  // yields a set with only `my_flag_3` set
+   *  s & r;
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  flag_set operator &(flag_set const &rhs) const {
+    return flag_set(*this) &= rhs;
+  }
+
+  /**
+   * Returns a set with the flags that are set in either this set or `rhs`.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  flag_set operator |(flag_set const &rhs) const {
+    return flag_set(*this) |= rhs;
+  }
+
+  /**
+   * Returns a set with the flags that are set in exactly one of this set and
+   * `rhs`.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  flag_set operator ^(flag_set const &rhs) const {
+    return flag_set(*this) ^= rhs;
+  }
+
+  /**
+   * Tells whether exactly the same flags are set in both this set and `rhs`.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  bool operator ==(flag_set const &rhs) const {
+    return storage::equal(flags_, rhs.flags_);
+  }
+
+  bool operator !=(flag_set const &rhs) const { return !(*this == rhs); }
+
 private:
   flags_type flags_;
 };
@@ -0,0 +1,152 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/container/atomic_flag_set.h>
+
+#include <fatal/test/driver.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace fatal {
+
+struct f0 {};
+struct f1 {};
+struct f2 {};
+struct f3 {};
+
+typedef atomic_flag_set<f0, f1, f2, f3> afs;
+typedef afs::set_type fs;
+
+TEST(atomic_flag_set, types) {
+  expect_same<flag_set<f0, f1, f2, f3>, afs::set_type>();
+  expect_same<fs::flags_type, afs::flags_type>();
+  expect_same<fs::tag_list, afs::tag_list>();
+}
+
+TEST(atomic_flag_set, ctor) {
+  afs s;
+  EXPECT_TRUE(s.is_lock_free());
+  EXPECT_EQ(0, s.load().get());
+
+  afs r(fs{f1(), f3()});
+  EXPECT_EQ(0b1010, r.load().get());
+}
+
+TEST(atomic_flag_set, set_unset) {
+  afs s;
+
+  s.set<f0, f2>();
+  EXPECT_EQ(0b0101, s.load().get());
+
+  s.set<f2, f3>(std::memory_order_release);
+  EXPECT_EQ(0b1101, s.load(std::memory_order_acquire).get());
+
+  s.unset<f0, f3>();
+  EXPECT_EQ(0b0100, s.load().get());
+
+  s.unset<f1>(std::memory_order_relaxed);
+  EXPECT_EQ(0b0100, s.load().get());
+
+  s.reset<f1, f3>();
+  EXPECT_EQ(0b1010, s.load().get());
+
+  s.clear();
+  EXPECT_EQ(0, s.load().get());
+}
+
+TEST(atomic_flag_set, is_set) {
+  afs s(fs{f0(), f2()});
+
+  EXPECT_TRUE(s.is_set<f0>());
+  EXPECT_TRUE((s.is_set<f0, f2>()));
+  EXPECT_TRUE(s.is_set<>());
+  EXPECT_FALSE(s.is_set<f1>());
+  EXPECT_FALSE((s.is_set<f0, f1>(std::memory_order_relaxed)));
+}
+
+TEST(atomic_flag_set, test_and_set) {
+  afs s;
+
+  EXPECT_FALSE((s.test_and_set<f0, f1>()));
+  EXPECT_EQ(0b0011, s.load().get());
+
+  EXPECT_TRUE(s.test_and_set<f1>());
+  EXPECT_FALSE((s.test_and_set<f1, f2>(std::memory_order_acq_rel)));
+  EXPECT_EQ(0b0111, s.load().get());
+
+  EXPECT_TRUE((s.test_and_unset<f0, f2>()));
+  EXPECT_EQ(0b0010, s.load().get());
+
+  EXPECT_FALSE((s.test_and_unset<f1, f3>()));
+  EXPECT_EQ(0, s.load().get());
+}
+
+TEST(atomic_flag_set, exchange) {
+  afs s(fs{f0()});
+
+  fs const previous = s.exchange(fs{f1(), f2()});
+  EXPECT_EQ(0b0001, previous.get());
+  EXPECT_EQ(0b0110, s.load().get());
+
+  s.store(fs{f3()});
+  EXPECT_EQ(0b1000, s.load().get());
+
+  fs expected{f0()};
+  EXPECT_FALSE(s.compare_exchange_strong(expected, fs{f1()}));
+  EXPECT_EQ(0b1000, expected.get());
+
+  EXPECT_TRUE(s.compare_exchange_strong(expected, fs{f1()}));
+  EXPECT_EQ(0b0010, s.load().get());
+
+  while (!s.compare_exchange_weak(expected, expected ^ fs{f0(), f1()})) {}
+  EXPECT_EQ(0b0001, s.load().get());
+}
+
+TEST(atomic_flag_set, single_flag) {
+  atomic_flag_set<f0> s;
+
+  EXPECT_FALSE(s.test_and_set<f0>());
+  EXPECT_TRUE(s.is_set<f0>());
+  EXPECT_TRUE(s.load().is_set<f0>());
+
+  s.unset<f0>();
+  EXPECT_FALSE(s.is_set<f0>());
+}
+
+TEST(atomic_flag_set, concurrent) {
+  afs s;
+  std::atomic<unsigned> winners(0);
+
+  std::vector<std::thread> threads;
+
+  for (auto i = 0; i < 8; ++i) {
+    threads.emplace_back([&s, &winners, i]() {
+      if (!s.test_and_set<f0>()) {
+        ++winners;
+      }
+
+      if (i % 2) {
+        s.set<f1>(std::memory_order_relaxed);
+      } else {
+        s.set<f2>(std::memory_order_relaxed);
+      }
+    });
+  }
+
+  for (auto &thread: threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(1, winners.load());
+  EXPECT_EQ(0b0111, s.load().get());
+}
+
+} // namespace fatal {
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/container/enum_array.h>
+
+#include <fatal/test/driver.h>
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace fatal {
+
+#define ENUMIFY_SPARSE_ENUM(FIRST, MID, LAST, ...) \
+  FIRST(field0, 3, __VA_ARGS__) \
+  MID(field1, 17, __VA_ARGS__) \
+  MID(field2, 101, __VA_ARGS__) \
+  LAST(field3, -5, __VA_ARGS__)
+FATAL_RICH_ENUM(sparse_enum, sparse_enum_str, ENUMIFY_SPARSE_ENUM);
+#undef ENUMIFY_SPARSE_ENUM
+
+#define ENUMIFY_DENSE_ENUM(FIRST, MID, LAST, ...) \
+  FIRST(a, __VA_ARGS__) \
+  MID(b, __VA_ARGS__) \
+  LAST(c, __VA_ARGS__)
+FATAL_RICH_ENUM(dense_enum, dense_enum_str, ENUMIFY_DENSE_ENUM);
+#undef ENUMIFY_DENSE_ENUM
+
+TEST(enum_array, enum_str_class) {
+  expect_same<sparse_enum_str, enum_str_class<sparse_enum>>();
+  expect_same<dense_enum_str, enum_str_class<dense_enum>>();
+}
+
+TEST(enum_array, size) {
+  EXPECT_EQ(4, (enum_array<sparse_enum, int>::size()));
+  EXPECT_EQ(3, (enum_array<dense_enum, int>::size()));
+
+  enum_array<sparse_enum, int> a;
+  EXPECT_EQ(a.size(), static_cast<std::size_t>(a.end() - a.begin()));
+  EXPECT_EQ(sizeof(int) * 4, sizeof(a));
+}
+
+TEST(enum_array, key) {
+  typedef enum_array<sparse_enum, int> array;
+
+  EXPECT_EQ(sparse_enum::field0, array::key(0));
+  EXPECT_EQ(sparse_enum::field1, array::key(1));
+  EXPECT_EQ(sparse_enum::field2, array::key(2));
+  EXPECT_EQ(sparse_enum::field3, array::key(3));
+
+  EXPECT_EQ(0, array::index_of(sparse_enum::field0));
+  EXPECT_EQ(1, array::index_of(sparse_enum::field1));
+  EXPECT_EQ(2, array::index_of(sparse_enum::field2));
+  EXPECT_EQ(3, array::index_of(sparse_enum::field3));
+  EXPECT_EQ(4, array::index_of(static_cast<sparse_enum>(18)));
+}
+
+TEST(enum_array, ctor) {
+  enum_array<sparse_enum, int> a;
+  for (auto i: a) {
+    EXPECT_EQ(0, i);
+  }
+
+  enum_array<dense_enum, int> const b(7);
+  for (auto i: b) {
+    EXPECT_EQ(7, i);
+  }
+}
+
+TEST(enum_array, access) {
+  enum_array<sparse_enum, int> a;
+
+  a[sparse_enum::field0] = 10;
+  a[sparse_enum::field1] = 11;
+  a.get<sparse_enum::field2>() = 12;
+  a.at(sparse_enum::field3) = 13;
+
+  auto const &c = a;
+
+  EXPECT_EQ(10, c.get<sparse_enum::field0>());
+  EXPECT_EQ(11, c.at(sparse_enum::field1));
+  EXPECT_EQ(12, c[sparse_enum::field2]);
+  EXPECT_EQ(13, c[sparse_enum::field3]);
+
+  EXPECT_EQ(10, c.data()[0]);
+  EXPECT_EQ(11, c.data()[1]);
+  EXPECT_EQ(12, c.data()[2]);
+  EXPECT_EQ(13, c.data()[3]);
+
+  EXPECT_THROW(a.at(static_cast<sparse_enum>(4)), std::out_of_range);
+  EXPECT_THROW(c.at(static_cast<sparse_enum>(-4)), std::out_of_range);
+}
+
+TEST(enum_array, iteration) {
+  typedef enum_array<sparse_enum, int> array;
+
+  array a;
+  a.fill(5);
+  a[sparse_enum::field2] = 9;
+
+  std::size_t n = 0;
+  for (auto i = a.cbegin(); i != a.cend(); ++i, ++n) {
+    EXPECT_EQ(
+      array::key(n) == sparse_enum::field2 ? 9 : 5,
+      *i
+    );
+    EXPECT_EQ(n, array::index_of(array::key(n)));
+  }
+  EXPECT_EQ(a.size(), n);
+}
+
+TEST(enum_array, compare) {
+  enum_array<dense_enum, int> a(1);
+  enum_array<dense_enum, int> b(1);
+
+  EXPECT_TRUE(a == b);
+  EXPECT_FALSE(a != b);
+
+  b[dense_enum::c] = 2;
+
+  EXPECT_FALSE(a == b);
+  EXPECT_TRUE(a != b);
+}
+
+} // namespace fatal {
@@ -9,6 +9,8 @@
 
 #include <fatal/container/flag_set.h>
 
+#include <fatal/type/sequence.h>
+
 #include <fatal/test/driver.h>
 
 #include <type_traits>
@@ -648,6 +650,16 @@ TEST(flag_set, expand_if) {
   }
 }
 
+TEST(flag_set, from_integral) {
+  check<fx>(0, fx::from_integral(0));
+  check<fx>(x0 | x3, fx::from_integral(x0 | x3));
+  check<fx>(x012345s.get(), fx::from_integral(x012345s.get()));
+  check<flag_set<>>(0, flag_set<>::from_integral(0));
+
+  EXPECT_TRUE(fx::from_integral(x2 | x5).is_set(x2, x5));
+  EXPECT_FALSE(fx::from_integral(x2 | x5).is_set(x1));
+}
+
 TEST(flag_set, operator_assignment) {
   fx s;
   EXPECT_EQ(0, s.get());
@@ -782,4 +794,205 @@ TEST(flag_set, clear) {
 # undef TEST_CLEAR
 }
 
+TEST(flag_set, count) {
+  EXPECT_EQ(0, fx().count());
+  EXPECT_EQ(1, x0s.count());
+  EXPECT_EQ(2, x23s.count());
+  EXPECT_EQ(6, x051423s.count());
+  EXPECT_EQ(0, flag_set<>().count());
+}
+
+TEST(flag_set, any_all) {
+  EXPECT_FALSE(fx().any());
+  EXPECT_FALSE(fx().all());
+
+  EXPECT_TRUE(x4s.any());
+  EXPECT_FALSE(x4s.all());
+
+  EXPECT_TRUE(x012345s.any());
+  EXPECT_TRUE(x012345s.all());
+}
+
+TEST(flag_set, bitwise_operators) {
+  check<fx>(0b000000, x01s & x23s);
+  check<fx>(0b000010, x01s & x1s);
+  check<fx>(0b001111, x01s | x23s);
+  check<fx>(0b001101, x01s ^ x1s ^ x23s);
+
+  X_COPY(c);
+
+  x01c |= x45s;
+  check<fx>(0b110011, x01c);
+
+  x01c &= x051423s;
+  check<fx>(0b110011, x01c);
+
+  x01c ^= x5s;
+  check<fx>(0b010011, x01c);
+}
+
+TEST(flag_set, equality) {
+  EXPECT_TRUE(x012345s == x543210s);
+  EXPECT_FALSE(x012345s != x543210s);
+
+  EXPECT_FALSE(x01s == x23s);
+  EXPECT_TRUE(x01s != x23s);
+
+  EXPECT_TRUE(fx() == fx());
+}
+
+template <int Size>
+using n_set = typename constant_range<int, 0, Size>::list::template apply<
+  flag_set
+>;
+
+template <int Value>
+using n = std::integral_constant<int, Value>;
+
+TEST(flag_set, multi_word) {
+  typedef n_set<64> s64;
+  typedef n_set<130> s130;
+
+  expect_same<std::array<std::uint64_t, 1>, s64::flags_type>();
+  expect_same<std::array<std::uint64_t, 3>, s130::flags_type>();
+
+  s130 s{n<0>(), n<63>(), n<64>(), n<129>()};
+
+  EXPECT_TRUE((s.is_set<n<0>, n<63>, n<64>, n<129>>()));
+  EXPECT_FALSE((s.is_set<n<0>, n<1>>()));
+  EXPECT_FALSE(s.is_set<n<65>>());
+  EXPECT_EQ(4, s.count());
+
+  EXPECT_EQ((std::uint64_t(1) << 63) | 1, s.get()[0]);
+  EXPECT_EQ(1, s.get()[1]);
+  EXPECT_EQ(2, s.get()[2]);
+
+  s.set<n<100>>();
+  EXPECT_TRUE(s.is_set(n<100>()));
+  EXPECT_EQ((std::uint64_t(1) << 36) | 1, s.get()[1]);
+
+  s.reset<n<128>>();
+  EXPECT_EQ(1, s.count());
+  EXPECT_EQ(0, s.get()[0]);
+  EXPECT_EQ(0, s.get()[1]);
+  EXPECT_EQ(1, s.get()[2]);
+
+  EXPECT_EQ(s, s130::from_integral(s.get()));
+
+  s.clear();
+  EXPECT_FALSE(s.any());
+  EXPECT_EQ(0, s.count());
+
+  s64 full;
+  EXPECT_FALSE(full.all());
+  full.set<n<63>>();
+  EXPECT_FALSE(full.all());
+
+  s64::flags_type words;
+  words.fill(~std::uint64_t(0));
+  full = s64::from_integral(words);
+  EXPECT_TRUE(full.all());
+  EXPECT_EQ(64, full.count());
+}
+
+TEST(flag_set, set_at) {
+  fx s;
+
+  s.set_at(0).set_at(3);
+  check<fx>(0b001001, s);
+
+  EXPECT_TRUE(s.is_set_at(0));
+  EXPECT_FALSE(s.is_set_at(1));
+  EXPECT_FALSE(s.is_set_at(2));
+  EXPECT_TRUE(s.is_set_at(3));
+
+  s.set_at(3);
+  check<fx>(0b001001, s);
+
+  typedef n_set<130> s130;
+  s130 m;
+
+  m.set_at(1).set_at(64).set_at(129);
+  EXPECT_TRUE((m.is_set<n<1>, n<64>, n<129>>()));
+  EXPECT_EQ(3, m.count());
+
+  EXPECT_TRUE(m.is_set_at(64));
+  EXPECT_TRUE(m.is_set_at(129));
+  EXPECT_FALSE(m.is_set_at(0));
+  EXPECT_FALSE(m.is_set_at(65));
+  EXPECT_FALSE(m.is_set_at(128));
+}
+
+TEST(flag_set, multi_word_operators) {
+  typedef n_set<200> s200;
+
+  s200 const a{n<1>(), n<70>(), n<150>(), n<199>()};
+  s200 const b{n<2>(), n<70>(), n<199>()};
+
+  EXPECT_EQ((s200{n<70>(), n<199>()}), a & b);
+  EXPECT_EQ((s200{n<1>(), n<2>(), n<70>(), n<150>(), n<199>()}), a | b);
+  EXPECT_EQ((s200{n<1>(), n<2>(), n<150>()}), a ^ b);
+
+  EXPECT_TRUE(a == a);
+  EXPECT_TRUE(a != b);
+  EXPECT_FALSE(a == b);
+
+  EXPECT_TRUE(a.any());
+  EXPECT_FALSE(s200().any());
+  EXPECT_FALSE(a.all());
+
+  s200 all;
+  all |= a;
+  all ^= all;
+  EXPECT_FALSE(all.any());
+}
+
+TEST(flag_set, multi_word_foreign) {
+  n_set<150> const big{n<3>(), n<5>(), n<80>(), n<149>()};
+
+  flag_set<n<149>, n<5>, n<7>> const small(big);
+  EXPECT_EQ(0b011, small.get());
+
+  n_set<100> const medium(big);
+  EXPECT_EQ((n_set<100>{n<3>(), n<5>(), n<80>()}), medium);
+
+  n_set<150> back(small);
+  EXPECT_EQ((n_set<150>{n<5>(), n<149>()}), back);
+}
+
+TEST(flag_set, foreign_permutation) {
+  typedef flag_set<x0t, x1t, x2t, x3t, x4t, x5t> from;
+  typedef flag_set<x5t, x0t, x1t, x2t, x3t, x4t> rotated;
+  typedef flag_set<x5t, x4t, x3t, x2t, x1t, x0t> reversed;
+
+  typedef detail::flag_set_impl::permutation<
+    detail::flag_set_impl::permutation_keys<from::tag_list, rotated::tag_list>
+  > rotation;
+  EXPECT_EQ(2, rotation::groups);
+
+  typedef detail::flag_set_impl::permutation<
+    detail::flag_set_impl::permutation_keys<from::tag_list, from::tag_list>
+  > identity;
+  EXPECT_EQ(1, identity::groups);
+
+  from const s(x0, x2, x5);
+  rotated const r(s);
+  reversed const v(s);
+  check<rotated>(0b001011, r);
+  check<reversed>(0b101001, v);
+  check<from>(0b100101, from(r));
+  check<from>(0b100101, from(v));
+
+  check<fy>(0b000100, fy(s));
+
+  // moving flags across words
+  typedef n_set<150> big;
+  typedef flag_set<n<149>, n<3>, n<64>, n<65>, n<66>, n<0>> small;
+
+  big const b{n<0>(), n<3>(), n<64>(), n<66>(), n<100>(), n<149>()};
+  small const m(b);
+  check<small>(0b110111, m);
+  EXPECT_EQ((big{n<0>(), n<3>(), n<64>(), n<66>(), n<149>()}), big(m));
+}
+
 } // namespace fatal {
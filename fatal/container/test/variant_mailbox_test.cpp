@@ -0,0 +1,198 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/container/variant_mailbox.h>
+
+#include <fatal/test/driver.h>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fatal {
+
+struct stop_message {};
+
+struct throwing_message {
+  explicit throwing_message(bool fail) {
+    if (fail) {
+      throw std::runtime_error("failed");
+    }
+  }
+};
+
+struct message_counter {
+  void operator ()(int value) { ints += value; ++count; }
+  void operator ()(double value) { doubles += value; ++count; }
+  void operator ()(std::string const &value) { strings += value; ++count; }
+  void operator ()(stop_message) { ++stops; ++count; }
+  void operator ()(throwing_message) { ++count; }
+
+  long long ints = 0;
+  double doubles = 0;
+  std::string strings;
+  std::size_t stops = 0;
+  std::size_t count = 0;
+};
+
+struct throwing_visitor {
+  template <typename T>
+  void operator ()(T const &) { throw std::runtime_error("visitor"); }
+};
+
+TEST(variant_mailbox, fifo) {
+  typedef auto_variant<int, double, stop_message> message;
+  variant_mailbox<message, 4> mailbox;
+
+  EXPECT_EQ(4, mailbox.capacity());
+  EXPECT_TRUE(mailbox.empty());
+
+  EXPECT_TRUE(mailbox.try_emplace<int>(1));
+  EXPECT_TRUE(mailbox.try_push(2.5));
+  EXPECT_TRUE(mailbox.try_emplace<stop_message>());
+  EXPECT_TRUE(mailbox.try_push(3));
+  EXPECT_FALSE(mailbox.try_push(4));
+  EXPECT_FALSE(mailbox.empty());
+
+  std::vector<int> order;
+  struct order_visitor {
+    void operator ()(int value, std::vector<int> &out) const {
+      out.push_back(value);
+    }
+    void operator ()(double, std::vector<int> &out) const {
+      out.push_back(-1);
+    }
+    void operator ()(stop_message, std::vector<int> &out) const {
+      out.push_back(-2);
+    }
+  };
+
+  EXPECT_TRUE(mailbox.try_consume(order_visitor(), order));
+  EXPECT_TRUE(mailbox.try_push(5));
+  EXPECT_EQ(4, mailbox.consume_all(10, order_visitor(), order));
+  EXPECT_FALSE(mailbox.try_consume(order_visitor(), order));
+  EXPECT_TRUE(mailbox.empty());
+
+  EXPECT_EQ((std::vector<int>{1, -1, -2, 3, 5}), order);
+}
+
+TEST(variant_mailbox, consume_all_limit) {
+  typedef auto_variant<int, double> message;
+  variant_mailbox<message, 8> mailbox;
+
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_TRUE(mailbox.try_push(i));
+  }
+
+  message_counter counter;
+  EXPECT_EQ(3, mailbox.consume_all(3, counter));
+  EXPECT_EQ(3, counter.count);
+  EXPECT_EQ(0 + 1 + 2, counter.ints);
+  EXPECT_EQ(5, mailbox.consume_all(100, counter));
+  EXPECT_EQ(28, counter.ints);
+  EXPECT_TRUE(mailbox.empty());
+}
+
+TEST(variant_mailbox, dynamic_allocation) {
+  typedef default_dynamic_variant<int, std::string> message;
+  std::allocator<void> allocator;
+  variant_mailbox<message, 2> mailbox(allocator);
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(mailbox.try_emplace<std::string>(3, 'x'));
+    EXPECT_TRUE(mailbox.try_push(i));
+    EXPECT_FALSE(mailbox.try_push(i));
+
+    message_counter counter;
+    EXPECT_EQ(2, mailbox.consume_all(2, counter));
+    EXPECT_EQ("xxx", counter.strings);
+    EXPECT_EQ(i, counter.ints);
+  }
+}
+
+TEST(variant_mailbox, throwing_constructor) {
+  typedef auto_variant<int, throwing_message> message;
+  variant_mailbox<message, 4> mailbox;
+
+  EXPECT_TRUE(mailbox.try_push(1));
+  EXPECT_THROW(mailbox.try_emplace<throwing_message>(true), std::runtime_error);
+  EXPECT_TRUE(mailbox.try_emplace<throwing_message>(false));
+
+  message_counter counter;
+  EXPECT_EQ(2, mailbox.consume_all(10, counter));
+  EXPECT_EQ(2, counter.count);
+  EXPECT_TRUE(mailbox.empty());
+
+  EXPECT_THROW(mailbox.try_emplace<throwing_message>(true), std::runtime_error);
+  EXPECT_TRUE(mailbox.empty());
+  EXPECT_FALSE(mailbox.try_consume(counter));
+  EXPECT_EQ(2, counter.count);
+
+  EXPECT_THROW(mailbox.try_emplace<throwing_message>(true), std::runtime_error);
+  EXPECT_TRUE(mailbox.try_push(2));
+  EXPECT_FALSE(mailbox.empty());
+  EXPECT_TRUE(mailbox.try_consume(counter));
+  EXPECT_EQ(3, counter.count);
+  EXPECT_EQ(3, counter.ints);
+  EXPECT_TRUE(mailbox.empty());
+
+  EXPECT_TRUE(mailbox.try_push(4));
+  EXPECT_TRUE(mailbox.try_push(5));
+  EXPECT_THROW(
+    mailbox.try_consume(throwing_visitor()),
+    std::runtime_error
+  );
+  EXPECT_TRUE(mailbox.try_consume(counter));
+  EXPECT_EQ(8, counter.ints);
+  EXPECT_TRUE(mailbox.empty());
+}
+
+TEST(variant_mailbox, multiple_producers) {
+  typedef auto_variant<int, double, stop_message> message;
+  variant_mailbox<message, 64> mailbox;
+
+  std::size_t const producers = 4;
+  int const messages = 10000;
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < producers; ++i) {
+    threads.emplace_back([&mailbox, messages]() {
+      for (int j = 1; j <= messages; ++j) {
+        while (!mailbox.try_push(j)) {
+          std::this_thread::yield();
+        }
+      }
+
+      while (!mailbox.try_emplace<stop_message>()) {
+        std::this_thread::yield();
+      }
+    });
+  }
+
+  message_counter counter;
+  while (counter.stops < producers) {
+    if (!mailbox.try_consume(counter)) {
+      std::this_thread::yield();
+    }
+  }
+
+  for (auto &t: threads) {
+    t.join();
+  }
+
+  EXPECT_TRUE(mailbox.empty());
+  EXPECT_EQ(producers * (messages + 1), counter.count);
+  EXPECT_EQ(
+    static_cast<long long>(producers) * messages * (messages + 1) / 2,
+    counter.ints
+  );
+}
+
+} // namespace fatal {
@@ -17,9 +17,12 @@
 #include <folly/String.h>
 #include <folly/dynamic.h>
 
+#include <algorithm>
+#include <array>
 #include <initializer_list>
 #include <map>
 #include <queue>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -406,6 +409,65 @@ TEST(variant, self_assignment) {
   EXPECT_EQ(10, (v1.get<int>()));
 }
 
+struct trivially_copyable_pod { int i; long l; };
+
+TEST(variant, trivially_copyable) {
+  EXPECT_TRUE((std::is_trivially_copyable<auto_variant<int, double>>::value));
+  EXPECT_TRUE((std::is_trivially_copyable<test_variant<int, double>>::value));
+  EXPECT_TRUE((
+    std::is_trivially_copyable<
+      auto_variant<int, trivially_copyable_pod>
+    >::value
+  ));
+  EXPECT_FALSE((
+    std::is_trivially_copyable<auto_variant<int, test_string>>::value
+  ));
+  EXPECT_FALSE((
+    std::is_trivially_copyable<default_dynamic_variant<int, double>>::value
+  ));
+  EXPECT_FALSE((
+    std::is_trivially_copyable<
+      variant<
+        default_storage_policy<std::allocator<void>, dynamic_allocation_policy>,
+        int
+      >
+    >::value
+  ));
+  EXPECT_FALSE((
+    std::is_trivially_copyable<
+      variant<
+        default_storage_policy<
+          std::allocator<void>, automatic_allocation_policy, false
+        >,
+        int
+      >
+    >::value
+  ));
+
+  typedef auto_variant<int, double, char> var;
+  std::vector<var> v;
+  for (int i = 0; i < 100; ++i) {
+    switch (i % 4) {
+      case 0: v.emplace_back(nullptr, i); break;
+      case 1: v.emplace_back(nullptr, i * .5); break;
+      case 2: v.emplace_back(nullptr, static_cast<char>(i)); break;
+      default: v.emplace_back(); break;
+    }
+  }
+
+  auto const copy = v;
+  ASSERT_EQ(v.size(), copy.size());
+  for (std::size_t i = 0; i < copy.size(); ++i) {
+    switch (i % 4) {
+      case 0: EXPECT_EQ(static_cast<int>(i), copy[i].get<int>()); break;
+      case 1: EXPECT_EQ(i * .5, copy[i].get<double>()); break;
+      case 2: EXPECT_EQ(static_cast<char>(i), copy[i].get<char>()); break;
+      default: EXPECT_TRUE(copy[i].empty()); break;
+    }
+  }
+  EXPECT_EQ(v, copy);
+}
+
 template <typename T, typename TStoragePolicy, typename ...Args>
 T const &copyset_constget_helper(
   variant<TStoragePolicy, Args...> &v, T const &value
@@ -664,6 +726,19 @@ TEST(variant, tag) {
   EXPECT_EQ(3, v.tag());
 }
 
+TEST(variant, type) {
+  test_variant<int, test_string, double> v(allocator);
+
+  v.set(10);
+  EXPECT_EQ(typeid(int), v.type());
+
+  v.set(test_string(allocator));
+  EXPECT_EQ(typeid(test_string), v.type());
+
+  v.set(1.0);
+  EXPECT_EQ(typeid(double), v.type());
+}
+
 TEST(variant, is_of) {
   test_variant<int, double> v(allocator);
   EXPECT_FALSE(v.is_of<int>());
@@ -953,13 +1028,14 @@ TEST(variant, operator_copy_assignment_rvref) {
   EXPECT_TRUE(id.empty());
   EXPECT_TRUE(ide.empty());
 
+  // moving from a trivially copyable variant leaves its value untouched
   id = std::move(id6_7);
   EXPECT_EQ(6.7, id.get<double>());
-  EXPECT_TRUE(id6_7.empty());
+  EXPECT_EQ(6.7, id6_7.get<double>());
 
   id = std::move(id5);
   EXPECT_EQ(5, id.get<int>());
-  EXPECT_TRUE(id5.empty());
+  EXPECT_EQ(5, id5.get<int>());
 
   id = std::move(i4);
   EXPECT_EQ(4, id.get<int>());
@@ -982,7 +1058,7 @@ TEST(variant, operator_copy_assignment_rvref) {
 
   i = std::move(i2);
   EXPECT_EQ(2, i.get<int>());
-  EXPECT_TRUE(i2.empty());
+  EXPECT_EQ(2, i2.get<int>());
 
   i = std::move(ie);
   EXPECT_TRUE(i.empty());
@@ -1118,13 +1194,14 @@ TEST(variant, operator_copy_assignment_heterogeneous_policy_rvref) {
   EXPECT_TRUE(id.empty());
   EXPECT_TRUE(ide.empty());
 
+  // moving from a trivially copyable variant leaves its value untouched
   id = std::move(id6_7);
   EXPECT_EQ(6.7, id.get<double>());
-  EXPECT_TRUE(id6_7.empty());
+  EXPECT_EQ(6.7, id6_7.get<double>());
 
   id = std::move(id5);
   EXPECT_EQ(5, id.get<int>());
-  EXPECT_TRUE(id5.empty());
+  EXPECT_EQ(5, id5.get<int>());
 
   id = std::move(i4);
   EXPECT_EQ(4, id.get<int>());
@@ -2050,6 +2127,88 @@ TEST(variant, set_difference_inplace) {
   EXPECT_EQ(expected, lhs);
 }
 
+TEST(variant, tracing_storage_policy) {
+  typedef tracing_storage_policy<
+    default_storage_policy<decltype(allocator)>,
+    struct tracing_storage_policy_test_tag
+  > policy;
+  typedef variant<policy, int, test_string, std::array<char, 256>> var;
+  typedef std::array<char, 256> big;
+
+  EXPECT_FALSE(std::is_trivially_copyable<var>::value);
+
+  {
+    var v(allocator, 10);
+    var w(v);
+    v = test_string("hello");
+    w = v;
+    v = big();
+    var u(std::move(v));
+
+    auto const i = policy::counters<int>();
+    EXPECT_FALSE(i.dynamic);
+    EXPECT_EQ(0, i.allocations);
+    EXPECT_EQ(0, i.deallocations);
+    EXPECT_EQ(2, i.constructions);
+    EXPECT_EQ(2, i.destructions);
+    EXPECT_EQ(0, i.live_objects());
+
+    auto const s = policy::counters<test_string>();
+    EXPECT_TRUE(s.dynamic);
+    EXPECT_EQ(2, s.allocations);
+    EXPECT_EQ(1, s.deallocations);
+    EXPECT_EQ(1, s.live_objects());
+    EXPECT_EQ(2 * sizeof(test_string), s.allocated_bytes);
+    EXPECT_EQ(sizeof(test_string), s.live_bytes());
+
+    auto const b = policy::counters<big>();
+    EXPECT_TRUE(b.dynamic);
+    EXPECT_EQ(1, b.allocations);
+    EXPECT_EQ(0, b.deallocations);
+    EXPECT_EQ(1, b.live_objects());
+    EXPECT_EQ(sizeof(big), b.live_bytes());
+  }
+
+  auto const s = policy::counters<test_string>();
+  EXPECT_EQ(2, s.allocations);
+  EXPECT_EQ(2, s.deallocations);
+  EXPECT_EQ(0, s.live_objects());
+  EXPECT_EQ(0, s.live_bytes());
+
+  auto const b = policy::counters<big>();
+  EXPECT_EQ(1, b.deallocations);
+  EXPECT_EQ(0, b.live_bytes());
+
+  std::ostringstream out;
+  policy::dump<var::types>(out);
+  auto const dump = out.str();
+  EXPECT_EQ(3, std::count(dump.begin(), dump.end(), '\n'));
+  EXPECT_NE(std::string::npos, dump.find(" allocations=2 deallocations=2 "));
+
+  policy::reset<test_string>();
+  EXPECT_EQ(0, policy::counters<test_string>().allocations);
+  EXPECT_EQ(2, policy::counters<int>().constructions);
+
+  {
+    var v(allocator, test_string("live"));
+    policy::reset<test_string>();
+
+    auto const live = policy::counters<test_string>();
+    EXPECT_EQ(0, live.allocations);
+    EXPECT_EQ(0, live.constructions);
+    EXPECT_EQ(1, live.live_objects());
+    EXPECT_EQ(sizeof(test_string), live.live_bytes());
+  }
+
+  auto const r = policy::counters<test_string>();
+  EXPECT_EQ(0, r.allocations);
+  EXPECT_EQ(1, r.deallocations);
+  EXPECT_EQ(0, r.constructions);
+  EXPECT_EQ(1, r.destructions);
+  EXPECT_EQ(0, r.live_objects());
+  EXPECT_EQ(0, r.live_bytes());
+}
+
 // This MUST be the LAST test.
 TEST(variant, memory_leak) {
   auto balance = allocated < freed
@@ -13,9 +13,11 @@
 #include <fatal/type/traits.h>
 #include <fatal/type/list.h>
 
+#include <atomic>
 #include <memory>
 #include <utility>
 #include <functional>
+#include <typeinfo>
 
 #include <cassert>
 
@@ -116,6 +118,11 @@ typedef fixed_allocation_policy<false> automatic_allocation_policy;
  *  static T const &get(typename storage_type<T>::type const &);
  *  static T &get(typename storage_type<T>::type &);
  *
+ * - is_trivially_copyable() tells whether the storage representation of T
+ *   can be copied and destroyed bitwise, bypassing the methods above:
+ *
+ *  template <typename T> constexpr static bool is_trivially_copyable();
+ *
  * TAllocator is any STL-style allocator which will be rebound to whatever
  * type the storage policy must handle. It will only be used for dynamically
  * allocated types.
@@ -171,12 +178,20 @@ struct default_storage_policy {
       >
     {
       // A union is used in order to facilitate uninitialized automatic storage.
-      union automatically_allocated{
+      template <typename V, bool = std::is_trivially_copyable<V>::value>
+      union automatically_allocated {
         automatically_allocated() {}
         automatically_allocated(automatically_allocated const &) {}
         automatically_allocated(automatically_allocated &&) {}
         ~automatically_allocated() {}
-        U value;
+        V value;
+      };
+
+      // Trivially copyable types keep the union trivially copyable as well.
+      template <typename V>
+      union automatically_allocated<V, true> {
+        automatically_allocated() {}
+        V value;
       };
 
       // A naked pointer is used for dynamically allocated types. no smart
@@ -184,7 +199,7 @@ struct default_storage_policy {
       // (having a copy of the deleter for every pointer is undesired).
       typedef typename std::conditional<
         allocation_policy::template allocate_dynamically<U>(),
-        U *, automatically_allocated
+        U *, automatically_allocated<U>
       >::type type;
     };
 
@@ -206,6 +221,19 @@ struct default_storage_policy {
     }
   };
 
+  /**
+   * Tells whether the storage for T can be copied, moved and destroyed
+   * bitwise, which is the case for trivially copyable types stored using
+   * automatic allocation. A variant whose types all satisfy this condition
+   * is trivially copyable itself.
+   */
+  template <typename T>
+  constexpr static bool is_trivially_copyable() {
+    return IsCopyable
+      && !storage_type<T>::allocate_dynamically()
+      && std::is_trivially_copyable<typename storage_type<T>::type>::value;
+  }
+
   // Methods for when T is stored using DYNAMIC ALLOCATION.
   //
   // The methods below are guaranteed to work on `T *` due to:
@@ -363,6 +391,226 @@ struct default_storage_policy {
   }
 };
 
+/**
+ * ############################
+ * # 'TRACING STORAGE POLICY' #
+ * ############################
+ *
+ * A storage policy that wraps another one (TStoragePolicy), forwarding every
+ * operation to it while keeping per type counters of allocations,
+ * deallocations, live objects and bytes. The intent is to gather data from
+ * production workloads in order to tune allocation policies.
+ *
+ * Counters are kept per (TStoragePolicy, TTag, T), and updated using relaxed
+ * atomic operations. Different tags can be used to tell apart variants that
+ * share the same policy and types.
+ *
+ * Example:
+ *
+ *  typedef tracing_storage_policy<
+ *    default_storage_policy<>, struct my_tag
+ *  > policy;
+ *
+ *  typedef variant<policy, int, std::string, std::vector<int>> var;
+ *
+ *  // ...
+ *
+ *  auto const c = policy::counters<std::string>();
+ *  LOG(INFO) << c.allocations << " strings allocated, "
+ *    << c.live_bytes() << " bytes still live";
+ *
+ *  // dumps one line per type
+ *  policy::dump<var::types>(std::cerr);
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <
+  typename TStoragePolicy = default_storage_policy<>,
+  typename TTag = void
+>
+struct tracing_storage_policy:
+  public TStoragePolicy
+{
+  typedef TStoragePolicy wrapped_policy;
+  typedef TTag tag;
+  typedef typename wrapped_policy::allocator_type allocator_type;
+
+  template <typename T>
+  using storage_type = typename wrapped_policy::template storage_type<T>;
+
+  // bitwise copies would bypass the counters
+  template <typename T>
+  constexpr static bool is_trivially_copyable() { return false; }
+
+  /**
+   * A snapshot of the counters for a given type.
+   */
+  struct counters_type {
+    // whether the type is stored using dynamic allocation
+    bool dynamic;
+    std::size_t allocations;
+    std::size_t deallocations;
+    std::size_t constructions;
+    std::size_t destructions;
+    std::size_t allocated_bytes;
+    std::size_t deallocated_bytes;
+    // tracked apart from the totals above, so that neither `reset()` nor
+    // concurrent updates can make them wrap around
+    std::size_t live_object_count;
+    std::size_t live_byte_count;
+
+    std::size_t live_objects() const { return live_object_count; }
+    std::size_t live_bytes() const { return live_byte_count; }
+  };
+
+  template <typename T>
+  static counters_type counters() {
+    auto const &c = counters_for<T>();
+
+    // each counter is loaded once, the ones that only grow after their
+    // counterparts go first, so that, even under concurrency, a snapshot
+    // never has more deallocations than allocations, for instance
+    auto const deallocations = c.deallocations.load(std::memory_order_relaxed);
+    auto const allocations = c.allocations.load(std::memory_order_relaxed);
+    auto const destructions = c.destructions.load(std::memory_order_relaxed);
+    auto const constructions = c.constructions.load(std::memory_order_relaxed);
+
+    return counters_type{
+      storage_type<T>::allocate_dynamically(),
+      allocations,
+      deallocations,
+      constructions,
+      destructions,
+      allocations * sizeof(T),
+      deallocations * sizeof(T),
+      c.live_objects.load(std::memory_order_relaxed),
+      c.live_allocations.load(std::memory_order_relaxed) * sizeof(T)
+    };
+  }
+
+  /**
+   * Zeroes the totals for the given type. Objects that are still live keep
+   * being accounted for by `live_objects()` and `live_bytes()`.
+   */
+  template <typename T>
+  static void reset() {
+    auto &c = counters_for<T>();
+
+    c.allocations.store(0, std::memory_order_relaxed);
+    c.deallocations.store(0, std::memory_order_relaxed);
+    c.constructions.store(0, std::memory_order_relaxed);
+    c.destructions.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * Writes one line per type in TList (e.g.: a variant's `types`) with its
+   * counters to the given output stream.
+   */
+  template <typename TList, typename TOut>
+  static void dump(TOut &out) {
+    TList::foreach(dump_visitor(), out);
+  }
+
+  template <typename T, typename... Args>
+  static void allocate(
+    allocator_type *allocator,
+    typename storage_type<T>::type &storage
+  ) {
+    wrapped_policy::template allocate<T, Args...>(allocator, storage);
+
+    if (storage_type<T>::allocate_dynamically()) {
+      auto &c = counters_for<T>();
+      c.allocations.fetch_add(1, std::memory_order_relaxed);
+      c.live_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  template <typename T>
+  static void deallocate(
+    allocator_type *allocator,
+    typename storage_type<T>::type &storage
+  ) {
+    wrapped_policy::template deallocate<T>(allocator, storage);
+
+    if (storage_type<T>::allocate_dynamically()) {
+      auto &c = counters_for<T>();
+      c.live_allocations.fetch_sub(1, std::memory_order_relaxed);
+      c.deallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  template <typename T, typename... Args>
+  static T &construct(
+    allocator_type *allocator,
+    typename storage_type<T>::type &storage,
+    Args &&...args
+  ) {
+    auto &result = wrapped_policy::template construct<T>(
+      allocator, storage, std::forward<Args>(args)...
+    );
+
+    auto &c = counters_for<T>();
+    c.constructions.fetch_add(1, std::memory_order_relaxed);
+    c.live_objects.fetch_add(1, std::memory_order_relaxed);
+
+    return result;
+  }
+
+  template <typename T>
+  static void destroy(
+    allocator_type *allocator,
+    typename storage_type<T>::type &storage
+  ) {
+    wrapped_policy::template destroy<T>(allocator, storage);
+
+    auto &c = counters_for<T>();
+    c.live_objects.fetch_sub(1, std::memory_order_relaxed);
+    c.destructions.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // moving the storage over constructs a value in the destination and
+  // destroys the source, leaving the counters unchanged
+  template <typename T>
+  static void move_over(
+    typename storage_type<T>::type &from,
+    typename storage_type<T>::type &to
+  ) {
+    wrapped_policy::template move_over<T>(from, to);
+  }
+
+private:
+  struct atomic_counters {
+    std::atomic<std::size_t> allocations;
+    std::atomic<std::size_t> deallocations;
+    std::atomic<std::size_t> constructions;
+    std::atomic<std::size_t> destructions;
+    std::atomic<std::size_t> live_allocations;
+    std::atomic<std::size_t> live_objects;
+  };
+
+  template <typename T>
+  static atomic_counters &counters_for() {
+    static atomic_counters instance{{0}, {0}, {0}, {0}, {0}, {0}};
+    return instance;
+  }
+
+  struct dump_visitor {
+    template <typename T, std::size_t Index, typename TOut>
+    void operator ()(indexed_type_tag<T, Index>, TOut &out) const {
+      auto const c = tracing_storage_policy::template counters<T>();
+
+      out << typeid(T).name()
+        << (c.dynamic ? " dynamic" : " automatic")
+        << " allocations=" << c.allocations
+        << " deallocations=" << c.deallocations
+        << " live_objects=" << c.live_objects()
+        << " allocated_bytes=" << c.allocated_bytes
+        << " live_bytes=" << c.live_bytes()
+        << '\n';
+    }
+  };
+};
+
 namespace detail {
 namespace variant_impl {
 
@@ -436,21 +684,32 @@ struct variadic_union_traits<TStoragePolicy, TSize, Depth, T> {
   typedef typename storage_policy::template storage_type<value_type>::type
     storage_type;
 
-  union union_type {
+private:
+  template <bool, typename = void>
+  union union_impl {
+    storage_type storage;
+    union_impl() {}
+    union_impl(union_impl const &) {}
+    union_impl(union_impl &&) {}
+    ~union_impl() {}
+  };
+
+  template <typename X>
+  union union_impl<true, X> {
     storage_type storage;
-    union_type() {}
-    union_type(union_type const &) {}
-    union_type(union_type &&) {}
-    ~union_type() {}
+    union_impl() {}
   };
 
+public:
+  typedef union_impl<std::is_trivially_copyable<storage_type>::value>
+    union_type;
+
   // calls not dependent on value_type
 
   constexpr static size_type end_depth() { return Depth + 1; }
 
-  static std::type_info const &type(size_type const depth) {
-    assert(depth == Depth);
-    return typeid(value_type);
+  constexpr static bool is_trivially_copyable() {
+    return storage_policy::template is_trivially_copyable<value_type>();
   }
 
   template <typename TVisitor, typename... UArgs>
@@ -609,23 +868,37 @@ struct variadic_union_traits<TStoragePolicy, TSize, Depth, T, Head, Tail...> {
     storage_policy, size_type, Depth + 1, Head, Tail...
   > tail_type;
 
-  union union_type {
+private:
+  template <bool, typename = void>
+  union union_impl {
+    typename head_type::union_type head;
+    typename tail_type::union_type tail;
+    union_impl() {}
+    union_impl(union_impl const &) {}
+    union_impl(union_impl &&) {}
+    ~union_impl() {}
+  };
+
+  template <typename X>
+  union union_impl<true, X> {
     typename head_type::union_type head;
     typename tail_type::union_type tail;
-    union_type() {}
-    union_type(union_type const &) {}
-    union_type(union_type &&) {}
-    ~union_type() {}
+    union_impl() {}
   };
 
+public:
+  typedef union_impl<
+    std::is_trivially_copyable<typename head_type::union_type>::value
+      && std::is_trivially_copyable<typename tail_type::union_type>::value
+  > union_type;
+
   // calls not dependent on value_type
 
   constexpr static size_type end_depth() { return tail_type::end_depth(); }
 
-  static std::type_info const &type(size_type const depth) {
-    return depth == Depth
-      ? head_type::type(depth)
-      : tail_type::type(depth);
+  constexpr static bool is_trivially_copyable() {
+    return head_type::is_trivially_copyable()
+      && tail_type::is_trivially_copyable();
   }
 
   template <typename TVisitor, typename... UArgs>
@@ -845,6 +1118,199 @@ public:
   }
 };
 
+/**
+ * This is the control block used by the variant to hold both the allocator
+ * and the type_tag of the type currently stored in the variant.
+ */
+template <typename TAllocator, typename TTypeTag>
+struct control_block {
+  typedef TAllocator allocator_type;
+  typedef TTypeTag type_tag;
+
+  control_block(allocator_type *allocator, type_tag storedType):
+    allocator_(std::move(allocator)),
+    tag_(std::move(storedType))
+  {}
+
+  fast_pass<type_tag> storedType() const { return tag_; }
+  void setStoredType(type_tag tag) { tag_ = std::move(tag); }
+
+  allocator_type *allocator() const { return allocator_; }
+
+  void set_allocator(allocator_type *allocator) {
+    allocator_ = std::move(allocator);
+  }
+
+  allocator_type *allocator_;
+  type_tag tag_;
+};
+
+/**
+ * Holds the storage of a variant (the union and the control block) and
+ * implements its copy, move and destruction semantics.
+ *
+ * When the storage policy reports every type as trivially copyable, the
+ * special members are left to the compiler so that the variant itself
+ * becomes trivially copyable (i.e.: copying a container of variants
+ * amounts to a memcpy). In that case moving from a variant leaves its
+ * value untouched, analogous to what happens with scalars.
+ *
+ * Otherwise, copies and moves are dispatched to the storage policy for
+ * the type currently stored.
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <
+  typename TTraits, typename TControlBlock,
+  bool = TTraits::storage_policy::is_copyable()
+    && TTraits::is_trivially_copyable()
+>
+struct variant_base;
+
+template <typename TTraits, typename TControlBlock>
+struct variant_base<TTraits, TControlBlock, true> {
+  typedef TTraits traits;
+  typedef TControlBlock control_block;
+  typedef typename traits::union_type union_type;
+  typedef typename traits::allocator_type allocator_type;
+
+  static_assert(
+    std::is_trivially_copyable<union_type>::value,
+    "storage policy reported a type that is not trivially copyable"
+  );
+
+  explicit variant_base(allocator_type *allocator):
+    control_(allocator, traits::end_depth())
+  {}
+
+protected:
+  // there's nothing to destroy or deallocate for trivially copyable types
+  void unset_impl(allocator_type *) {
+    control_.setStoredType(traits::end_depth());
+  }
+
+  union_type union_;
+  control_block control_;
+};
+
+template <typename TTraits, typename TControlBlock>
+struct variant_base<TTraits, TControlBlock, false> {
+  typedef TTraits traits;
+  typedef TControlBlock control_block;
+  typedef typename traits::union_type union_type;
+  typedef typename traits::allocator_type allocator_type;
+  typedef typename traits::storage_policy storage_policy;
+
+  explicit variant_base(allocator_type *allocator):
+    control_(allocator, traits::end_depth())
+  {}
+
+  variant_base(variant_base const &other):
+    control_(copy_impl(other))
+  {
+    static_assert(
+      storage_policy::is_copyable(),
+      "copy construction disabled by the variant's policy"
+    );
+  }
+
+  /* may throw */
+  variant_base(variant_base &&other):
+    control_(move_impl(std::move(other)))
+  {}
+
+  ~variant_base() { unset_impl(control_.allocator()); }
+
+  variant_base &operator =(variant_base const &other) {
+    static_assert(
+      storage_policy::is_copyable(),
+      "copy assignment disabled by the variant's policy"
+    );
+
+    if (this != std::addressof(other)) {
+      unset_impl(control_.allocator());
+      control_ = copy_impl(other);
+    }
+
+    return *this;
+  }
+
+  variant_base &operator =(variant_base &&other) {
+    if (this != std::addressof(other)) {
+      unset_impl(control_.allocator());
+      control_ = move_impl(std::move(other));
+    }
+
+    return *this;
+  }
+
+protected:
+  void unset_impl(allocator_type *allocator) {
+    auto const storedType = control_.storedType();
+
+    if (storedType == traits::end_depth()) {
+      return;
+    }
+
+    traits::destroy(allocator, storedType, union_);
+    traits::deallocate(allocator, storedType, union_);
+    control_.setStoredType(traits::end_depth());
+  }
+
+  union_type union_;
+  control_block control_;
+
+private:
+  // assumes already unset
+  control_block copy_impl(variant_base const &other) {
+    auto const otherStoredType = other.control_.storedType();
+    auto otherAllocator = other.control_.allocator();
+
+    if (otherStoredType == traits::end_depth()) {
+      return other.control_;
+    }
+
+    traits::allocate(otherAllocator, otherStoredType, union_);
+    try {
+      traits::copy_construct(
+        otherAllocator, otherStoredType, other.union_, union_
+      );
+    } catch(...) {
+      traits::deallocate(otherAllocator, otherStoredType, union_);
+      throw;
+    }
+
+    return other.control_;
+  }
+
+  // assumes already unset
+  control_block move_impl(variant_base &&other) {
+    auto const otherStoredType = other.control_.storedType();
+
+    if (otherStoredType != traits::end_depth()) {
+      traits::move_over(otherStoredType, other.union_, union_);
+    }
+
+    auto control = std::move(other.control_);
+    other.control_.setStoredType(traits::end_depth());
+    return std::move(control);
+  }
+};
+
+template <typename TStoragePolicy, typename... Args>
+using variant_base_for = variant_base<
+  variadic_union_traits<
+    TStoragePolicy,
+    smallest_uint_for_value<sizeof...(Args)>,
+    std::numeric_limits<smallest_uint_for_value<sizeof...(Args)>>::min(),
+    typename std::remove_reference<Args>::type...
+  >,
+  control_block<
+    typename TStoragePolicy::allocator_type,
+    smallest_uint_for_value<sizeof...(Args)>
+  >
+>;
+
 } // namespace variant_impl {
 } // namespace detail {
 
@@ -881,50 +1347,24 @@ struct is_variant<variant<UStoragePolicy, UArgs...>>:
  * @author: Marcelo Juchem <marcelo@fb.com>
  */
 template <typename TStoragePolicy, typename... Args>
-struct variant {
+struct variant:
+  private detail::variant_impl::variant_base_for<TStoragePolicy, Args...>
+{
   typedef TStoragePolicy storage_policy;
   typedef typename storage_policy::allocator_type allocator_type;
   typedef type_list<Args...> types;
 
 private:
-  /**
-   * This is the control block used by the variant to hold both the allocator
-   * and the type_tag of the type currently stored in the variant.
-   */
-  struct control_block {
-    // bits_size is the amount of bits needed to represent the type_tag for
-    // the given types passed as variadic template parameters (Args...)
-    constexpr static std::size_t bits_size() {
-      return most_significant_bit_mp<sizeof...(Args)>();
-    }
-
-    typedef smallest_uint_for_value<sizeof...(Args)> type_tag;
-
-    control_block(allocator_type *allocator, type_tag storedType):
-      allocator_(std::move(allocator)),
-      tag_(std::move(storedType))
-    {}
-
-    fast_pass<type_tag> storedType() const { return tag_; }
-    void setStoredType(type_tag tag) { tag_ = std::move(tag); }
-
-    allocator_type *allocator() const { return allocator_; }
+  typedef detail::variant_impl::variant_base_for<TStoragePolicy, Args...> base;
+  typedef typename base::control_block control_block;
 
-    void set_allocator(allocator_type *allocator) {
-      allocator_ = std::move(allocator);
-    }
-
-    allocator_type *allocator_;
-    type_tag tag_;
-  };
+  using base::union_;
+  using base::control_;
+  using base::unset_impl;
 
 public:
   typedef typename control_block::type_tag type_tag;
-  typedef fatal::detail::variant_impl::variadic_union_traits<
-    storage_policy,
-    type_tag, std::numeric_limits<type_tag>::min(),
-    typename std::remove_reference<Args>::type...
-  > traits;
+  typedef typename base::traits traits;
   typedef typename traits::union_type union_type;
 
   // returns no_tag() when the given type is not part of the variant
@@ -948,30 +1388,21 @@ public:
    * standard containers.
    */
   explicit variant():
-    control_(nullptr, no_tag())
+    base(nullptr)
   {}
 
   explicit variant(allocator_type &allocator):
-    control_(std::addressof(allocator), no_tag())
+    base(std::addressof(allocator))
   {}
 
-  variant(variant const &other):
-    control_(copy_impl(other))
-  {
-    static_assert(
-      storage_policy::is_copyable(),
-      "copy construction disabled by the variant's policy"
-    );
-  }
+  variant(variant const &) = default;
 
   /* may throw */
-  variant(variant &&other):
-    control_(move_impl(std::move(other)))
-  {}
+  variant(variant &&) = default;
 
   template <typename U>
   explicit variant(allocator_type *allocator, U &&value):
-    control_(allocator, no_tag())
+    base(allocator)
   {
     set<
       typename std::remove_const<
@@ -1002,8 +1433,6 @@ public:
     other.visit(copy_variant_visitor<true, false>(), *this);
   }
 
-  ~variant() { unset_impl(control_.allocator()); }
-
   /**
    * The unchecked_get won't perform type checks. The user must ensure the
    * requested type matches the one stored in the variant. Provided for
@@ -1082,7 +1511,7 @@ public:
   bool visit_if(UVisitor &&visitor, UArgs &&...args) const {
     bool result = false;
 
-    return types::template binary_search<index_value_comparer>::exact(
+    return types::template lookup<index_value_comparer>::exact(
       control_.storedType(),
       detail::variant_impl::visit_if_visitor<UCondition>(),
       *this, result,
@@ -1098,7 +1527,7 @@ public:
   bool visit_if(UVisitor &&visitor, UArgs &&...args) {
     bool result = false;
 
-    return types::template binary_search<index_value_comparer>::exact(
+    return types::template lookup<index_value_comparer>::exact(
       control_.storedType(),
       detail::variant_impl::visit_if_visitor<UCondition>(),
       *this, result,
@@ -1261,7 +1690,7 @@ public:
 
   // for compatibility with boost::variant
   std::type_info const &type() const {
-    return traits::type(control_.storedType());
+    return types::type_at(control_.storedType());
   }
 
   allocator_type &allocator() const { return *control_.allocator(); }
@@ -1271,32 +1700,8 @@ public:
     control_.set_allocator(std::addressof(allocator));
   }
 
-  variant &operator =(variant const &other) {
-    static_assert(
-      storage_policy::is_copyable(),
-      "copy assignment disabled by the variant's policy"
-    );
-
-    if (this != std::addressof(other)) {
-      unset_impl(control_.allocator());
-      control_ = copy_impl(other);
-    }
-
-    return *this;
-  }
-
-  variant &operator =(variant &other) {
-    return (*this = static_cast<variant const &>(other));
-  }
-
-  variant &operator =(variant &&other) {
-    if (this != std::addressof(other)) {
-      unset_impl(control_.allocator());
-      control_ = move_impl(std::move(other));
-    }
-
-    return *this;
-  }
+  variant &operator =(variant const &) = default;
+  variant &operator =(variant &&) = default;
 
   template <typename U>
   U const &operator =(U const &value) {
@@ -1317,7 +1722,12 @@ public:
     return *this;
   }
 
-  template <typename UStoragePolicy, typename... UArgs>
+  template <
+    typename UStoragePolicy, typename... UArgs,
+    typename X = safe_ctor_overload_t<
+      variant, variant<UStoragePolicy, UArgs...>
+    >
+  >
   variant &operator =(variant<UStoragePolicy, UArgs...> &other) {
     if (!other.visit(copy_variant_visitor<false, true>(), *this)) {
       clear();
@@ -1390,9 +1800,6 @@ public:
   bool operator >=(variant const &other) const { return !(*this < other); }
 
 private:
-  union_type union_;
-  control_block control_;
-
   template <typename U, typename... UArgs>
   U &set_impl(UArgs &&...args) {
     auto const storedType = control_.storedType();
@@ -1431,53 +1838,6 @@ private:
     }
   }
 
-  void unset_impl(allocator_type *allocator) {
-    auto const storedType = control_.storedType();
-
-    if (storedType == no_tag()) {
-      return;
-    }
-
-    traits::destroy(allocator, storedType, union_);
-    traits::deallocate(allocator, storedType, union_);
-    control_.setStoredType(no_tag());
-  }
-
-  // assumes already unset
-  control_block copy_impl(variant const &other) {
-    auto const otherStoredType = other.control_.storedType();
-    auto otherAllocator = other.control_.allocator();
-
-    if (otherStoredType == no_tag()) {
-      return other.control_;
-    }
-
-    traits::allocate(otherAllocator, otherStoredType, union_);
-    try {
-      traits::copy_construct(
-        otherAllocator, otherStoredType, other.union_, union_
-      );
-    } catch(...) {
-      traits::deallocate(otherAllocator, otherStoredType, union_);
-      throw;
-    }
-
-    return other.control_;
-  }
-
-  // assumes already unset
-  control_block move_impl(variant &&other) {
-    auto const otherStoredType = other.control_.storedType();
-
-    if (otherStoredType != no_tag()) {
-      traits::move_over(otherStoredType, other.union_, union_);
-    }
-
-    auto control = std::move(other.control_);
-    other.control_.setStoredType(no_tag());
-    return std::move(control);
-  }
-
   template <bool ThrowIfUnsupported, bool ClearIfUnsupported>
   class copy_variant_visitor {
     template <typename U, bool>
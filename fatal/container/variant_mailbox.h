@@ -0,0 +1,284 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#pragma once
+
+#include <fatal/container/variant.h>
+
+#include <array>
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+
+namespace fatal {
+
+/**
+ * A bounded, lock-free, multi-producer / single-consumer queue of variants,
+ * intended as a zero-allocation message channel between threads.
+ *
+ * Each slot of the ring buffer holds a variant of type TVariant, and values
+ * are constructed in place in the slot by the producers (no intermediate
+ * variant is built and moved around). The consumer dispatches the message
+ * in the slot to a visitor, exactly as if it was calling `TVariant::visit()`,
+ * then clears the slot.
+ *
+ * When TVariant only stores types using automatic allocation (for instance,
+ * `auto_variant`), sending and receiving messages won't allocate any memory.
+ * Otherwise the allocator given to the constructor is used by every slot.
+ *
+ * Any number of threads can produce messages concurrently, but only a single
+ * thread at a time is allowed to consume them.
+ *
+ * The implementation follows Dmitry Vyukov's bounded queue: every slot has a
+ * sequence number telling whether it's ready to be written or to be read, so
+ * producers only contend on a single atomic increment.
+ *
+ * Capacity must be a power of 2.
+ *
+ * Example:
+ *
+ *  struct stop {};
+ *  typedef auto_variant<int, double, stop> message;
+ *
+ *  variant_mailbox<message, 1024> mailbox;
+ *
+ *  // on any of the producer threads
+ *  mailbox.try_emplace<int>(10);
+ *  mailbox.try_push(5.6);
+ *  mailbox.try_emplace<stop>();
+ *
+ *  // on the consumer thread
+ *  struct handler {
+ *    void operator ()(int value) { ... }
+ *    void operator ()(double value) { ... }
+ *    void operator ()(stop) { ... }
+ *  };
+ *
+ *  while (mailbox.try_consume(handler())) {}
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <typename TVariant, std::size_t Capacity>
+class variant_mailbox {
+  static_assert(is_variant<TVariant>::value, "TVariant must be a variant");
+  static_assert(Capacity > 1, "capacity must be greater than 1");
+  static_assert(
+    (Capacity & (Capacity - 1)) == 0,
+    "capacity must be a power of 2"
+  );
+
+  struct slot {
+    std::atomic<std::size_t> sequence;
+    TVariant value;
+  };
+
+  // the size of a cache line, used to keep producers and consumer apart
+  enum { padding = 64 };
+
+public:
+  typedef TVariant value_type;
+  typedef typename value_type::allocator_type allocator_type;
+  typedef std::size_t size_type;
+
+  explicit variant_mailbox() {
+    initialize(nullptr);
+  }
+
+  explicit variant_mailbox(allocator_type &allocator) {
+    initialize(std::addressof(allocator));
+  }
+
+  variant_mailbox(variant_mailbox const &) = delete;
+  variant_mailbox(variant_mailbox &&) = delete;
+
+  variant_mailbox &operator =(variant_mailbox const &) = delete;
+  variant_mailbox &operator =(variant_mailbox &&) = delete;
+
+  constexpr static size_type capacity() { return Capacity; }
+
+  /**
+   * Constructs a value of type U in place, given the arguments `args`.
+   *
+   * Returns false, without evaluating the constructor, when the mailbox is
+   * full. Safe to call concurrently from any number of threads.
+   *
+   * If the constructor throws, the slot is published as an empty message,
+   * which is skipped by the consumer, and the exception is propagated.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename U, typename... UArgs>
+  bool try_emplace(UArgs &&...args) {
+    static_assert(
+      value_type::template is_supported<U>(),
+      "type not supported by the variant"
+    );
+
+    auto position = tail_.load(std::memory_order_relaxed);
+    slot *s;
+
+    for (;;) {
+      s = std::addressof(slots_[position & (Capacity - 1)]);
+
+      auto const sequence = s->sequence.load(std::memory_order_acquire);
+      auto const difference = static_cast<std::ptrdiff_t>(sequence)
+        - static_cast<std::ptrdiff_t>(position);
+
+      if (difference == 0) {
+        if (
+          tail_.compare_exchange_weak(
+            position, position + 1, std::memory_order_relaxed
+          )
+        ) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = tail_.load(std::memory_order_relaxed);
+      }
+    }
+
+    try {
+      s->value.template emplace<U>(std::forward<UArgs>(args)...);
+    } catch (...) {
+      s->sequence.store(position + 1, std::memory_order_release);
+      throw;
+    }
+
+    s->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Convenience wrapper for `try_emplace()` that deduces the type of the
+   * message from the given value.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename U>
+  bool try_push(U &&value) {
+    return try_emplace<typename std::decay<U>::type>(std::forward<U>(value));
+  }
+
+  /**
+   * Calls `visitor(message, args...)` for the oldest message in the mailbox,
+   * if any, then clears its slot.
+   *
+   * Empty messages, left behind by constructors that threw in
+   * `try_emplace()`, are silently dropped along the way.
+   *
+   * If the visitor throws, the message is still dropped and the exception
+   * is propagated.
+   *
+   * Returns true when a message was visited, or false if the mailbox is
+   * empty. Must only be called by the consumer thread.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename TVisitor, typename... UArgs>
+  bool try_consume(TVisitor &&visitor, UArgs &&...args) {
+    for (;;) {
+      auto &s = slots_[head_ & (Capacity - 1)];
+
+      if (s.sequence.load(std::memory_order_acquire) != head_ + 1) {
+        return false;
+      }
+
+      if (s.value.empty()) {
+        release(s);
+        continue;
+      }
+
+      try {
+        s.value.visit(
+          std::forward<TVisitor>(visitor),
+          std::forward<UArgs>(args)...
+        );
+      } catch (...) {
+        release(s);
+        throw;
+      }
+
+      release(s);
+      return true;
+    }
+  }
+
+  /**
+   * Consumes messages until the mailbox is found empty, or until `limit`
+   * messages have been consumed.
+   *
+   * Returns the number of messages visited, not counting the empty ones that
+   * were skipped. Must only be called by the consumer thread.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename TVisitor, typename... UArgs>
+  size_type consume_all(
+    size_type limit, TVisitor &&visitor, UArgs &&...args
+  ) {
+    size_type count = 0;
+
+    while (count < limit && try_consume(visitor, args...)) {
+      ++count;
+    }
+
+    return count;
+  }
+
+  /**
+   * Tells whether there are no messages ready to be consumed.
+   *
+   * Must only be called by the consumer thread.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  bool empty() const {
+    // empty messages don't count, as `try_consume()` skips them
+    for (auto position = head_; ; ++position) {
+      auto const &s = slots_[position & (Capacity - 1)];
+
+      if (s.sequence.load(std::memory_order_acquire) != position + 1) {
+        return true;
+      }
+
+      if (!s.value.empty()) {
+        return false;
+      }
+    }
+  }
+
+private:
+  void initialize(allocator_type *allocator) {
+    for (size_type i = 0; i < Capacity; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+
+      if (allocator) {
+        slots_[i].value.set_allocator(*allocator);
+      }
+    }
+
+    tail_.store(0, std::memory_order_release);
+  }
+
+  void release(slot &s) {
+    s.value.clear();
+    s.sequence.store(head_ + Capacity, std::memory_order_release);
+    ++head_;
+  }
+
+  std::array<slot, Capacity> slots_;
+  alignas(padding) std::atomic<size_type> tail_;
+  alignas(padding) size_type head_ = 0;
+};
+
+} // namespace fatal {
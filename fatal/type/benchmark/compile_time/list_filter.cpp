@@ -0,0 +1,24 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/benchmark/compile_time.h>
+
+namespace fatal {
+namespace compile_time {
+
+template <typename T>
+using is_even = std::integral_constant<bool, T::value % 2 == 0>;
+
+typedef generate<shuffled>::filter<is_even> result;
+
+static_assert(result::first::size == (size + 1) / 2, "unexpected size");
+static_assert(result::second::size == size / 2, "unexpected size");
+
+} // namespace compile_time {
+} // namespace fatal {
@@ -0,0 +1,26 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/benchmark/compile_time.h>
+
+namespace fatal {
+namespace compile_time {
+
+template <std::size_t Index>
+using nested = type_list<
+  value<Index>,
+  type_list<value<Index + size>, type_list<value<Index + 2 * size>>>
+>;
+
+typedef generate<nested>::flatten<> result;
+
+static_assert(result::size == 3 * size, "unexpected size");
+
+} // namespace compile_time {
+} // namespace fatal {
@@ -0,0 +1,25 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/benchmark/compile_time.h>
+
+#include <fatal/type/map.h>
+
+namespace fatal {
+namespace compile_time {
+
+template <std::size_t Index>
+using entry = type_pair<repeated<Index>, value<Index>>;
+
+typedef generate<entry>::apply<type_map>::cluster<> result;
+
+static_assert(result::size == size / 2 + 1, "unexpected size");
+
+} // namespace compile_time {
+} // namespace fatal {
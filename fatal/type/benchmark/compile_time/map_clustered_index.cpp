@@ -0,0 +1,37 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/benchmark/compile_time.h>
+
+#include <fatal/type/map.h>
+
+namespace fatal {
+namespace compile_time {
+
+template <std::size_t Index>
+struct metadata {
+  typedef value<Index % 7> l1;
+  typedef value<Index % 5> l2;
+  typedef value<Index % 3> l3;
+  typedef value<Index> l4;
+};
+
+template <typename T> using get_l1 = typename T::l1;
+template <typename T> using get_l2 = typename T::l2;
+template <typename T> using get_l3 = typename T::l3;
+template <typename T> using get_l4 = typename T::l4;
+
+typedef clustered_index<
+  generate<metadata>, get_l1, get_l2, get_l3, get_l4
+> result;
+
+static_assert(result::size == (size < 7 ? size : 7), "unexpected size");
+
+} // namespace compile_time {
+} // namespace fatal {
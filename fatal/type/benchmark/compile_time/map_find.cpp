@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/benchmark/compile_time.h>
+
+#include <fatal/type/map.h>
+
+namespace fatal {
+namespace compile_time {
+
+template <std::size_t Index>
+using entry = type_pair<shuffled<Index>, value<Index>>;
+
+typedef generate<entry>::apply<type_map> map;
+
+// looks up keys spread throughout the map
+#define FATAL_IMPL_FIND(Index) \
+  static_assert( \
+    std::is_same<value<Index>, map::find<shuffled<Index>>>::value, \
+    "unexpected mapped type" \
+  );
+
+FATAL_IMPL_FIND(size * 0 / 8)
+FATAL_IMPL_FIND(size * 1 / 8)
+FATAL_IMPL_FIND(size * 2 / 8)
+FATAL_IMPL_FIND(size * 3 / 8)
+FATAL_IMPL_FIND(size * 4 / 8)
+FATAL_IMPL_FIND(size * 5 / 8)
+FATAL_IMPL_FIND(size * 6 / 8)
+FATAL_IMPL_FIND(size * 7 / 8)
+FATAL_IMPL_FIND(size - 1)
+
+#undef FATAL_IMPL_FIND
+
+static_assert(
+  std::is_same<type_not_found_tag, map::find<value<size>>>::value,
+  "unexpected mapped type"
+);
+
+} // namespace compile_time {
+} // namespace fatal {
@@ -0,0 +1,38 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/benchmark/compile_time.h>
+
+#include <fatal/type/map.h>
+
+namespace fatal {
+namespace compile_time {
+
+template <std::size_t Index>
+using entry = type_pair<shuffled<Index>, value<Index>>;
+
+typedef generate<entry>::apply<type_map> map;
+
+// looks up every key in the map, as `clustered_index` and the enum string
+// maps end up doing
+template <std::size_t Index>
+using found = typename std::is_same<
+  value<Index>, map::find<shuffled<Index>>
+>::type;
+
+template <std::size_t>
+using expected = std::true_type;
+
+static_assert(
+  std::is_same<generate<expected>, generate<found>>::value,
+  "unexpected mapped type"
+);
+
+} // namespace compile_time {
+} // namespace fatal {
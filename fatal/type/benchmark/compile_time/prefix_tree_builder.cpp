@@ -0,0 +1,40 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/benchmark/compile_time.h>
+
+#include <fatal/type/prefix_tree.h>
+
+namespace fatal {
+namespace compile_time {
+
+template <std::size_t Index>
+using letter = std::integral_constant<
+  char, static_cast<char>('a' + Index % 26)
+>;
+
+// distinct strings sharing prefixes, as long as `size` < 26^3
+template <std::size_t Index>
+using string = type_list<
+  letter<Index / (26 * 26)>,
+  letter<Index / 26>,
+  letter<Index>,
+  letter<Index * 7>
+>;
+
+typedef generate<string>::apply<type_prefix_tree_builder<>::build> result;
+
+static_assert(size < 26 * 26 * 26, "too many strings");
+static_assert(
+  result::map::size == (size + 26 * 26 - 1) / (26 * 26),
+  "unexpected size"
+);
+
+} // namespace compile_time {
+} // namespace fatal {
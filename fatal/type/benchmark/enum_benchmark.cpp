@@ -0,0 +1,327 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/type/enum.h>
+
+#include <fatal/benchmark/driver.h>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+namespace fatal {
+
+//////////////////////////////
+// BENCHMARK IMPLEMENTATION //
+//////////////////////////////
+
+template <typename Enum, typename TStr>
+struct enum_benchmark_impl {
+  // the names of all fields, interleaved with as many strings that aren't,
+  // in random order
+  static std::vector<std::string> const &input() {
+    static auto const result = []() {
+      std::vector<std::string> v;
+
+      for (std::size_t i = 0; i < TStr::string_table::size; ++i) {
+        std::string s(
+          TStr::string_table::c_str(i),
+          TStr::string_table::length(i)
+        );
+        v.push_back(s);
+        s.back() = '#';
+        v.push_back(std::move(s));
+      }
+
+      std::srand(0);
+      for (auto i = v.size(); i > 1; --i) {
+        std::swap(v[i - 1], v[static_cast<std::size_t>(std::rand()) % i]);
+      }
+
+      return v;
+    }();
+
+    return result;
+  }
+
+  struct prefix_tree_visitor {
+    template <typename TString>
+    void operator ()(type_tag<TString>, Enum &out) {
+      out = TStr::str_to_value::template find<TString>::value;
+    }
+  };
+
+  static void prefix_tree_benchmark(std::size_t iterations) {
+    std::vector<std::string> const *v;
+    unsigned count = 0;
+
+    BENCHMARK_SUSPEND {
+      v = std::addressof(input());
+    }
+
+    while (iterations--) {
+      for (auto const &s: *v) {
+        Enum out;
+        count += TStr::prefix_tree::template match<>::exact(
+          s.begin(), s.end(), prefix_tree_visitor(), out
+        );
+      }
+    }
+
+    folly::doNotOptimizeAway(count);
+  }
+
+  static void perfect_hash_benchmark(std::size_t iterations) {
+    std::vector<std::string> const *v;
+    unsigned count = 0;
+
+    BENCHMARK_SUSPEND {
+      v = std::addressof(input());
+    }
+
+    while (iterations--) {
+      for (auto const &s: *v) {
+        Enum out;
+        count += TStr::try_parse(out, s);
+      }
+    }
+
+    folly::doNotOptimizeAway(count);
+  }
+
+  static void parse_batch_benchmark(std::size_t iterations) {
+    std::vector<std::string> const *v;
+    std::vector<Enum> out;
+    std::vector<char> valid;
+    unsigned count = 0;
+
+    BENCHMARK_SUSPEND {
+      v = std::addressof(input());
+      out.resize(v->size());
+      valid.resize(v->size());
+    }
+
+    while (iterations--) {
+      count += TStr::parse_batch(*v, out.begin(), valid.begin());
+    }
+
+    folly::doNotOptimizeAway(count);
+  }
+
+  static void std_unordered_map_benchmark(std::size_t iterations) {
+    std::vector<std::string> const *v;
+    std::unordered_map<std::string, Enum> map;
+    unsigned count = 0;
+
+    BENCHMARK_SUSPEND {
+      v = std::addressof(input());
+
+      for (std::size_t i = 0; i < TStr::string_table::size; ++i) {
+        std::string s(TStr::string_table::c_str(i));
+        map.emplace(s, TStr::parse(s));
+      }
+    }
+
+    while (iterations--) {
+      for (auto const &s: *v) {
+        count += map.find(s) != map.end();
+      }
+    }
+
+    folly::doNotOptimizeAway(count);
+  }
+};
+
+///////////////////////
+// ENUMS DECLARATION //
+///////////////////////
+
+#define ENUMIFY_ENUM_N8(FIRST, MID, LAST, ...) \
+  FIRST(response_threshold, __VA_ARGS__) \
+  MID(socket_limit, __VA_ARGS__) \
+  MID(request_threshold, __VA_ARGS__) \
+  MID(write_depth, __VA_ARGS__) \
+  MID(request_depth, __VA_ARGS__) \
+  MID(client_mode, __VA_ARGS__) \
+  MID(client_limit, __VA_ARGS__) \
+  LAST(thread_mode, __VA_ARGS__)
+FATAL_RICH_ENUM(enum_n8, enum_n8_str, ENUMIFY_ENUM_N8);
+#undef ENUMIFY_ENUM_N8
+
+#define ENUMIFY_ENUM_N32(FIRST, MID, LAST, ...) \
+  FIRST(backup_timeout, __VA_ARGS__) \
+  MID(cache_capacity, __VA_ARGS__) \
+  MID(buffer_interval, __VA_ARGS__) \
+  MID(idle_timeout, __VA_ARGS__) \
+  MID(compaction_level, __VA_ARGS__) \
+  MID(max_count, __VA_ARGS__) \
+  MID(client_size, __VA_ARGS__) \
+  MID(cache_level, __VA_ARGS__) \
+  MID(idle_threshold, __VA_ARGS__) \
+  MID(client_enabled, __VA_ARGS__) \
+  MID(read_threshold, __VA_ARGS__) \
+  MID(log_delay, __VA_ARGS__) \
+  MID(cache_limit, __VA_ARGS__) \
+  MID(queue_threshold, __VA_ARGS__) \
+  MID(session_count, __VA_ARGS__) \
+  MID(socket_size, __VA_ARGS__) \
+  MID(buffer_ratio, __VA_ARGS__) \
+  MID(response_size, __VA_ARGS__) \
+  MID(connect_period, __VA_ARGS__) \
+  MID(log_limit, __VA_ARGS__) \
+  MID(log_level, __VA_ARGS__) \
+  MID(socket_count, __VA_ARGS__) \
+  MID(queue_period, __VA_ARGS__) \
+  MID(log_policy, __VA_ARGS__) \
+  MID(cache_depth, __VA_ARGS__) \
+  MID(cache_policy, __VA_ARGS__) \
+  MID(read_period, __VA_ARGS__) \
+  MID(cache_mode, __VA_ARGS__) \
+  MID(connect_interval, __VA_ARGS__) \
+  MID(thread_policy, __VA_ARGS__) \
+  MID(buffer_depth, __VA_ARGS__) \
+  LAST(response_mode, __VA_ARGS__)
+FATAL_RICH_ENUM(enum_n32, enum_n32_str, ENUMIFY_ENUM_N32);
+#undef ENUMIFY_ENUM_N32
+
+#define ENUMIFY_ENUM_N100(FIRST, MID, LAST, ...) \
+  FIRST(request_period, __VA_ARGS__) \
+  MID(client_delay, __VA_ARGS__) \
+  MID(max_enabled, __VA_ARGS__) \
+  MID(request_size, __VA_ARGS__) \
+  MID(connect_mode, __VA_ARGS__) \
+  MID(client_count, __VA_ARGS__) \
+  MID(read_mode, __VA_ARGS__) \
+  MID(socket_mode, __VA_ARGS__) \
+  MID(queue_interval, __VA_ARGS__) \
+  MID(session_level, __VA_ARGS__) \
+  MID(request_mode, __VA_ARGS__) \
+  MID(buffer_threshold, __VA_ARGS__) \
+  MID(buffer_count, __VA_ARGS__) \
+  MID(backup_interval, __VA_ARGS__) \
+  MID(compaction_interval, __VA_ARGS__) \
+  MID(session_depth, __VA_ARGS__) \
+  MID(min_size, __VA_ARGS__) \
+  MID(client_ratio, __VA_ARGS__) \
+  MID(response_level, __VA_ARGS__) \
+  MID(write_delay, __VA_ARGS__) \
+  MID(write_size, __VA_ARGS__) \
+  MID(write_threshold, __VA_ARGS__) \
+  MID(response_depth, __VA_ARGS__) \
+  MID(buffer_timeout, __VA_ARGS__) \
+  MID(session_timeout, __VA_ARGS__) \
+  MID(socket_delay, __VA_ARGS__) \
+  MID(retry_capacity, __VA_ARGS__) \
+  MID(queue_timeout, __VA_ARGS__) \
+  MID(max_limit, __VA_ARGS__) \
+  MID(idle_ratio, __VA_ARGS__) \
+  MID(server_delay, __VA_ARGS__) \
+  MID(retry_delay, __VA_ARGS__) \
+  MID(log_depth, __VA_ARGS__) \
+  MID(session_ratio, __VA_ARGS__) \
+  MID(compaction_size, __VA_ARGS__) \
+  MID(idle_count, __VA_ARGS__) \
+  MID(connect_count, __VA_ARGS__) \
+  MID(connect_ratio, __VA_ARGS__) \
+  MID(queue_capacity, __VA_ARGS__) \
+  MID(retry_enabled, __VA_ARGS__) \
+  MID(server_ratio, __VA_ARGS__) \
+  MID(read_level, __VA_ARGS__) \
+  MID(socket_level, __VA_ARGS__) \
+  MID(socket_interval, __VA_ARGS__) \
+  MID(read_delay, __VA_ARGS__) \
+  MID(response_policy, __VA_ARGS__) \
+  MID(client_interval, __VA_ARGS__) \
+  MID(connect_timeout, __VA_ARGS__) \
+  MID(min_period, __VA_ARGS__) \
+  MID(buffer_mode, __VA_ARGS__) \
+  MID(thread_level, __VA_ARGS__) \
+  MID(queue_mode, __VA_ARGS__) \
+  MID(server_size, __VA_ARGS__) \
+  MID(read_depth, __VA_ARGS__) \
+  MID(backup_mode, __VA_ARGS__) \
+  MID(queue_depth, __VA_ARGS__) \
+  MID(compaction_timeout, __VA_ARGS__) \
+  MID(backup_enabled, __VA_ARGS__) \
+  MID(log_count, __VA_ARGS__) \
+  MID(idle_mode, __VA_ARGS__) \
+  MID(connect_size, __VA_ARGS__) \
+  MID(read_interval, __VA_ARGS__) \
+  MID(max_period, __VA_ARGS__) \
+  MID(max_threshold, __VA_ARGS__) \
+  MID(server_mode, __VA_ARGS__) \
+  MID(queue_limit, __VA_ARGS__) \
+  MID(compaction_ratio, __VA_ARGS__) \
+  MID(thread_limit, __VA_ARGS__) \
+  MID(compaction_mode, __VA_ARGS__) \
+  MID(compaction_capacity, __VA_ARGS__) \
+  MID(connect_policy, __VA_ARGS__) \
+  MID(min_count, __VA_ARGS__) \
+  MID(client_timeout, __VA_ARGS__) \
+  MID(backup_threshold, __VA_ARGS__) \
+  MID(read_ratio, __VA_ARGS__) \
+  MID(client_policy, __VA_ARGS__) \
+  MID(max_mode, __VA_ARGS__) \
+  MID(queue_count, __VA_ARGS__) \
+  MID(request_timeout, __VA_ARGS__) \
+  MID(thread_enabled, __VA_ARGS__) \
+  MID(cache_ratio, __VA_ARGS__) \
+  MID(backup_capacity, __VA_ARGS__) \
+  MID(cache_threshold, __VA_ARGS__) \
+  MID(server_capacity, __VA_ARGS__) \
+  MID(write_level, __VA_ARGS__) \
+  MID(idle_interval, __VA_ARGS__) \
+  MID(connect_capacity, __VA_ARGS__) \
+  MID(response_count, __VA_ARGS__) \
+  MID(compaction_limit, __VA_ARGS__) \
+  MID(session_policy, __VA_ARGS__) \
+  MID(max_size, __VA_ARGS__) \
+  MID(backup_period, __VA_ARGS__) \
+  MID(session_size, __VA_ARGS__) \
+  MID(retry_ratio, __VA_ARGS__) \
+  MID(buffer_policy, __VA_ARGS__) \
+  MID(read_limit, __VA_ARGS__) \
+  MID(cache_enabled, __VA_ARGS__) \
+  MID(connect_enabled, __VA_ARGS__) \
+  MID(cache_delay, __VA_ARGS__) \
+  LAST(min_depth, __VA_ARGS__)
+FATAL_RICH_ENUM(enum_n100, enum_n100_str, ENUMIFY_ENUM_N100);
+#undef ENUMIFY_ENUM_N100
+
+//////////////////////////////
+// BENCHMARKS INSTANTIATION //
+//////////////////////////////
+
+#define CREATE_BENCHMARK(Enum) \
+  typedef enum_benchmark_impl<Enum, Enum##_str> Enum##_impl; \
+  BENCHMARK(Enum##_type_prefix_tree, iterations) { \
+    Enum##_impl::prefix_tree_benchmark(iterations); \
+  } \
+  BENCHMARK_RELATIVE(Enum##_perfect_hash, iterations) { \
+    Enum##_impl::perfect_hash_benchmark(iterations); \
+  } \
+  BENCHMARK_RELATIVE(Enum##_parse_batch, iterations) { \
+    Enum##_impl::parse_batch_benchmark(iterations); \
+  } \
+  BENCHMARK_RELATIVE(Enum##_std_unordered_map, iterations) { \
+    Enum##_impl::std_unordered_map_benchmark(iterations); \
+  }
+
+CREATE_BENCHMARK(enum_n8)
+BENCHMARK_DRAW_LINE();
+CREATE_BENCHMARK(enum_n32)
+BENCHMARK_DRAW_LINE();
+CREATE_BENCHMARK(enum_n100)
+
+#undef CREATE_BENCHMARK
+
+} // namespace fatal {
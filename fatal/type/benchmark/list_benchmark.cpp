@@ -0,0 +1,225 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/type/list.h>
+#include <fatal/type/sequence.h>
+
+#include <fatal/benchmark/driver.h>
+
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+namespace fatal {
+
+//////////////////////////////
+// BENCHMARK IMPLEMENTATION //
+//////////////////////////////
+
+// the linear chain of comparisons used by `type_list::visit` before it was
+// backed by a dispatch table for longer lists, kept as a reference
+template <std::size_t Index, typename... Args> struct linear_visit;
+
+template <std::size_t Index, typename T, typename... Args>
+struct linear_visit<Index, T, Args...> {
+  template <typename V, typename... VArgs>
+  static bool at(std::size_t index, V &&visitor, VArgs &&...args) {
+    return index == Index
+      ? (
+        visitor(indexed_type_tag<T, Index>(), std::forward<VArgs>(args)...),
+        true
+      )
+      : linear_visit<Index + 1, Args...>::at(
+        index, std::forward<V>(visitor), std::forward<VArgs>(args)...
+      );
+  }
+};
+
+template <std::size_t Index>
+struct linear_visit<Index> {
+  template <typename V, typename... VArgs>
+  static bool at(std::size_t, V &&, VArgs &&...) { return false; }
+};
+
+template <typename... Args>
+using linear_visit_list = linear_visit<0, Args...>;
+
+struct visitor {
+  template <typename T, std::size_t Index>
+  void operator ()(indexed_type_tag<T, Index>, std::size_t &count) {
+    count += (T::value * 2654435761u) >> (Index % 7);
+  }
+};
+
+template <std::size_t Size>
+struct benchmark_impl {
+  typedef typename constant_range<std::size_t, 0, Size>::list list;
+
+  // random indexes so that branch prediction doesn't favor either approach
+  static std::vector<std::size_t> const &indexes() {
+    static auto const result = []() {
+      std::vector<std::size_t> v(4096);
+      std::srand(0);
+      for (auto &i: v) {
+        i = static_cast<std::size_t>(std::rand()) % Size;
+      }
+      return v;
+    }();
+
+    return result;
+  }
+
+  static void type_list_benchmark(std::size_t iterations) {
+    std::size_t count = 0;
+    std::vector<std::size_t> const *v;
+
+    BENCHMARK_SUSPEND {
+      v = std::addressof(indexes());
+    }
+
+    while (iterations--) {
+      for (auto i: *v) {
+        list::visit(i, visitor(), count);
+      }
+    }
+
+    folly::doNotOptimizeAway(count);
+  }
+
+  static void linear_benchmark(std::size_t iterations) {
+    std::size_t count = 0;
+    std::vector<std::size_t> const *v;
+
+    BENCHMARK_SUSPEND {
+      v = std::addressof(indexes());
+    }
+
+    while (iterations--) {
+      for (auto i: *v) {
+        list::template apply<linear_visit_list>::at(i, visitor(), count);
+      }
+    }
+
+    folly::doNotOptimizeAway(count);
+  }
+};
+
+struct dense_keys {
+  template <typename T>
+  using key = T;
+
+  static std::size_t value(std::size_t i) { return i; }
+};
+
+struct sparse_keys {
+  template <typename T>
+  using key = std::integral_constant<std::size_t, T::value * T::value * 7>;
+
+  static std::size_t value(std::size_t i) { return i * i * 7; }
+};
+
+struct lookup_visitor {
+  template <typename T, std::size_t Index>
+  void operator ()(
+    indexed_type_tag<T, Index>,
+    std::size_t needle,
+    std::size_t &count
+  ) {
+    count += (needle * 2654435761u) >> (Index % 7);
+  }
+};
+
+template <std::size_t Size, typename TKeys>
+struct lookup_benchmark_impl {
+  typedef typename constant_range<std::size_t, 0, Size>::list
+    ::template transform<TKeys::template key> list;
+
+  // random needles, a quarter of which won't be found
+  static std::vector<std::size_t> const &needles() {
+    static auto const result = []() {
+      std::vector<std::size_t> v(4096);
+      std::srand(0);
+      for (auto &i: v) {
+        auto const key = static_cast<std::size_t>(std::rand()) % Size;
+        i = TKeys::value(key) + (std::rand() % 4 == 0);
+      }
+      return v;
+    }();
+
+    return result;
+  }
+
+  template <typename TSearch>
+  static void run(std::size_t iterations) {
+    std::size_t count = 0;
+    std::vector<std::size_t> const *v;
+
+    BENCHMARK_SUSPEND {
+      v = std::addressof(needles());
+    }
+
+    while (iterations--) {
+      for (auto i: *v) {
+        TSearch::exact(i, lookup_visitor(), count);
+      }
+    }
+
+    folly::doNotOptimizeAway(count);
+  }
+
+  static void lookup_benchmark(std::size_t iterations) {
+    run<typename list::template lookup<>>(iterations);
+  }
+
+  static void binary_search_benchmark(std::size_t iterations) {
+    run<typename list::template binary_search<>>(iterations);
+  }
+};
+
+//////////////////////////////
+// BENCHMARKS INSTANTIATION //
+//////////////////////////////
+
+#define CREATE_BENCHMARK(Size) \
+  BENCHMARK(visit_n##Size##_type_list, iterations) { \
+    benchmark_impl<Size>::type_list_benchmark(iterations); \
+  } \
+  BENCHMARK_RELATIVE(visit_n##Size##_linear, iterations) { \
+    benchmark_impl<Size>::linear_benchmark(iterations); \
+  }
+
+CREATE_BENCHMARK(8)
+BENCHMARK_DRAW_LINE();
+CREATE_BENCHMARK(64)
+BENCHMARK_DRAW_LINE();
+CREATE_BENCHMARK(128)
+BENCHMARK_DRAW_LINE();
+CREATE_BENCHMARK(256)
+
+#undef CREATE_BENCHMARK
+
+#define CREATE_BENCHMARK(Name, Size, Key) \
+  BENCHMARK(lookup_##Name##_n##Size, iterations) { \
+    lookup_benchmark_impl<Size, Key>::lookup_benchmark(iterations); \
+  } \
+  BENCHMARK_RELATIVE(binary_search_##Name##_n##Size, iterations) { \
+    lookup_benchmark_impl<Size, Key>::binary_search_benchmark(iterations); \
+  }
+
+BENCHMARK_DRAW_LINE();
+CREATE_BENCHMARK(dense, 64, dense_keys)
+BENCHMARK_DRAW_LINE();
+CREATE_BENCHMARK(sparse, 8, sparse_keys)
+BENCHMARK_DRAW_LINE();
+CREATE_BENCHMARK(sparse, 64, sparse_keys)
+BENCHMARK_DRAW_LINE();
+CREATE_BENCHMARK(sparse, 300, sparse_keys)
+
+} // namespace fatal {
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/type/list.h>
+#include <fatal/type/sequence.h>
+
+#include <fatal/benchmark/driver.h>
+
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+namespace fatal {
+
+//////////////////////////////
+// BENCHMARK IMPLEMENTATION //
+//////////////////////////////
+
+struct bucket_visitor {
+  template <typename T, std::size_t Index>
+  void operator ()(indexed_type_tag<T, Index>, int, std::size_t &out) {
+    out = Index;
+  }
+};
+
+template <std::size_t Size>
+struct bucketize_benchmark_impl {
+  template <typename T>
+  using boundary = std::integral_constant<int, T::value * 4>;
+
+  typedef typename constant_range<int, 0, Size>::list
+    ::template apply_type_values<int, constant_sequence, boundary> sequence;
+
+  // random values, some of which fall outside of the boundaries
+  static std::vector<int> const &values() {
+    static auto const result = []() {
+      std::vector<int> v(4096);
+      std::srand(0);
+      for (auto &i: v) {
+        i = static_cast<int>(std::rand() % (Size * 4 + 8)) - 4;
+      }
+      return v;
+    }();
+
+    return result;
+  }
+
+  static void bucketize_benchmark(std::size_t iterations) {
+    std::vector<int> const *v;
+    std::vector<std::size_t> out;
+
+    BENCHMARK_SUSPEND {
+      v = std::addressof(values());
+      out.resize(v->size());
+    }
+
+    while (iterations--) {
+      sequence::bucketize(v->begin(), v->end(), out.begin());
+      folly::doNotOptimizeAway(out.front());
+    }
+  }
+
+  static void binary_search_benchmark(std::size_t iterations) {
+    std::vector<int> const *v;
+    std::vector<std::size_t> out;
+
+    BENCHMARK_SUSPEND {
+      v = std::addressof(values());
+      out.resize(v->size());
+    }
+
+    while (iterations--) {
+      auto o = out.begin();
+      for (auto i: *v) {
+        sequence::list::template binary_search<>::lower_bound(
+          i, bucket_visitor(), *o++
+        );
+      }
+      folly::doNotOptimizeAway(out.front());
+    }
+  }
+};
+
+//////////////////////////////
+// BENCHMARKS INSTANTIATION //
+//////////////////////////////
+
+#define CREATE_BENCHMARK(Size) \
+  BENCHMARK(bucketize_n##Size, iterations) { \
+    bucketize_benchmark_impl<Size>::bucketize_benchmark(iterations); \
+  } \
+  BENCHMARK_RELATIVE(binary_search_n##Size, iterations) { \
+    bucketize_benchmark_impl<Size>::binary_search_benchmark(iterations); \
+  }
+
+CREATE_BENCHMARK(8)
+BENCHMARK_DRAW_LINE();
+CREATE_BENCHMARK(32)
+BENCHMARK_DRAW_LINE();
+CREATE_BENCHMARK(256)
+
+#undef CREATE_BENCHMARK
+
+} // namespace fatal {
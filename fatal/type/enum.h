@@ -9,15 +9,18 @@
 
 #pragma once
 
+#include <fatal/container/flag_set.h>
 #include <fatal/preprocessor.h>
 #include <fatal/type/string.h>
 #include <fatal/type/prefix_tree.h>
 
+#include <algorithm>
 #include <type_traits>
 #include <iterator>
 #include <utility>
 #include <stdexcept>
 
+#include <cstdint>
 #include <cstring>
 
 namespace fatal {
@@ -122,6 +125,1093 @@ namespace fatal {
  * @author: Marcelo Juchem <marcelo@fb.com>
  */
 
+////////////////////////////
+// IMPLEMENTATION DETAILS //
+////////////////////////////
+
+namespace detail {
+namespace enum_impl {
+
+//////////////////
+// string_table //
+//////////////////
+
+// concatenates the strings, each followed by a null terminator, keeping track
+// of the offset where each of them starts plus a final one past the end
+template <typename TChars, typename TOffsets, typename... TStrings>
+struct string_table_builder {
+  typedef TChars chars;
+  typedef TOffsets offsets;
+};
+
+template <
+  typename TChar, TChar... Pool, std::size_t... Offsets,
+  TChar... Chars, typename... TStrings
+>
+struct string_table_builder<
+  constant_sequence<TChar, Pool...>,
+  constant_sequence<std::size_t, Offsets...>,
+  type_string<TChar, Chars...>,
+  TStrings...
+>:
+  public string_table_builder<
+    constant_sequence<TChar, Pool..., Chars..., static_cast<TChar>(0)>,
+    constant_sequence<
+      std::size_t, Offsets..., sizeof...(Pool) + sizeof...(Chars) + 1
+    >,
+    TStrings...
+  >
+{};
+
+template <typename, typename> struct string_table_data;
+
+template <typename TChar, TChar... Chars, std::size_t... Offsets>
+struct string_table_data<
+  constant_sequence<TChar, Chars...>,
+  constant_sequence<std::size_t, Offsets...>
+> {
+  typedef TChar char_type;
+
+  static constexpr std::size_t size = sizeof...(Offsets) - 1;
+
+  static constexpr char_type data[sizeof...(Chars)] = { Chars... };
+  static constexpr std::size_t offset[sizeof...(Offsets)] = { Offsets... };
+
+  static constexpr char_type const *c_str(std::size_t index) {
+    return data + offset[index];
+  }
+
+  static constexpr std::size_t length(std::size_t index) {
+    return offset[index + 1] - offset[index] - 1;
+  }
+};
+
+template <typename TChar, TChar... Chars, std::size_t... Offsets>
+constexpr std::size_t string_table_data<
+  constant_sequence<TChar, Chars...>,
+  constant_sequence<std::size_t, Offsets...>
+>::size;
+
+template <typename TChar, TChar... Chars, std::size_t... Offsets>
+constexpr TChar string_table_data<
+  constant_sequence<TChar, Chars...>,
+  constant_sequence<std::size_t, Offsets...>
+>::data[sizeof...(Chars)];
+
+template <typename TChar, TChar... Chars, std::size_t... Offsets>
+constexpr std::size_t string_table_data<
+  constant_sequence<TChar, Chars...>,
+  constant_sequence<std::size_t, Offsets...>
+>::offset[sizeof...(Offsets)];
+
+template <typename TString, typename... TStrings>
+using string_table = string_table_data<
+  typename string_table_builder<
+    constant_sequence<typename TString::char_type>,
+    constant_sequence<std::size_t, 0>,
+    TString, TStrings...
+  >::chars,
+  typename string_table_builder<
+    constant_sequence<typename TString::char_type>,
+    constant_sequence<std::size_t, 0>,
+    TString, TStrings...
+  >::offsets
+>;
+
+/////////////////
+// value_table //
+/////////////////
+
+template <typename T, T... Values>
+struct value_table {
+  static constexpr T data[sizeof...(Values)] = { Values... };
+};
+
+template <typename T, T... Values>
+constexpr T value_table<T, Values...>::data[sizeof...(Values)];
+
+//////////////
+// is_dense //
+//////////////
+
+template <typename T>
+constexpr std::uintmax_t as_uint(T value) {
+  return static_cast<std::uintmax_t>(
+    static_cast<typename std::underlying_type<T>::type>(value)
+  );
+}
+
+template <typename, typename T, T...>
+struct is_dense_impl: public std::true_type {};
+
+// tells whether the values are contiguous and in ascending order, in which
+// case the index of a value is its distance from the first one - modular
+// arithmetic yields the correct distance for signed types too
+template <std::size_t... Indexes, typename T, T First, T... Values>
+struct is_dense_impl<
+  type_list_impl::index_pack<Indexes...>, T, First, Values...
+>:
+  public type_list_impl::all_of<
+    as_uint(Values) - as_uint(First) == Indexes + 1 ...
+  >
+{};
+
+template <typename T, T... Values>
+using is_dense = is_dense_impl<
+  typename type_list_impl::make_index_pack<
+    sizeof...(Values) ? sizeof...(Values) - 1 : 0
+  >::type,
+  T, Values...
+>;
+
+//////////////////
+// perfect_hash //
+//////////////////
+
+// a perfect hash built at compile time with the hash and displace technique:
+// strings are first split into buckets, which are then placed, one at a time,
+// by finding the first displacement that moves all of the bucket's strings
+// into free slots of the table
+
+// FNV-1a
+constexpr std::uint64_t hash_basis = 14695981039346656037ull;
+constexpr std::uint64_t hash_prime = 1099511628211ull;
+
+// multiplicative mixing, whose higher bits are then used as the index
+constexpr std::uint64_t hash_bucket_mix = 0x9e3779b97f4a7c15ull;
+constexpr std::uint64_t hash_slot_mix = 0xff51afd7ed558ccdull;
+
+template <typename TChar>
+constexpr std::uint64_t hash_char(std::uint64_t hash, TChar c) {
+  return (
+    hash ^ static_cast<typename std::make_unsigned<TChar>::type>(c)
+  ) * hash_prime;
+}
+
+template <typename TChar>
+constexpr std::uint64_t hash_str(
+  std::uint64_t hash, TChar const *s, std::size_t length
+) {
+  return length ? hash_str(hash_char(hash, *s), s + 1, length - 1) : hash;
+}
+
+constexpr std::size_t hash_bucket(std::uint64_t hash, std::size_t bits) {
+  return static_cast<std::size_t>((hash * hash_bucket_mix) >> (64 - bits));
+}
+
+constexpr std::size_t hash_slot(
+  std::uint64_t hash, std::size_t displacement, std::size_t bits
+) {
+  return static_cast<std::size_t>(
+    ((hash ^ (displacement * hash_bucket_mix)) * hash_slot_mix) >> (64 - bits)
+  );
+}
+
+// the amount of bits needed to index `size` elements, at least 1
+constexpr std::size_t hash_bits(std::size_t size, std::size_t bits = 1) {
+  return (std::size_t(1) << bits) < size ? hash_bits(size, bits + 1) : bits;
+}
+
+// how many characters to hash from each end of a string of the given length
+constexpr std::size_t hash_width(std::size_t length, std::size_t width) {
+  return width < length ? width : length;
+}
+
+// hashes the length of the string, along with up to `width` characters from
+// each of its ends
+template <typename TChar>
+constexpr std::uint64_t hash_ends(
+  TChar const *s, std::size_t length, std::size_t width
+) {
+  return hash_str(
+    hash_str(
+      (hash_basis ^ length) * hash_prime,
+      s,
+      hash_width(length, width)
+    ),
+    s + (length - hash_width(length, width)),
+    hash_width(length, width)
+  );
+}
+
+template <std::size_t Size>
+struct perfect_hash_layout {
+  static constexpr std::size_t size = Size;
+
+  // two keys per bucket and a load factor of at most one half, on average
+  static constexpr std::size_t bucket_bits = hash_bits(size / 2);
+  static constexpr std::size_t slot_bits = hash_bits(size * 2);
+
+  static constexpr std::size_t buckets = std::size_t(1) << bucket_bits;
+  static constexpr std::size_t slots = std::size_t(1) << slot_bits;
+};
+
+template <typename TTable, std::size_t Width>
+struct perfect_hash_params:
+  public perfect_hash_layout<TTable::size>
+{
+  static constexpr std::size_t width = Width;
+
+  static constexpr std::uint64_t hash(std::size_t index) {
+    return hash_ends(TTable::c_str(index), TTable::length(index), Width);
+  }
+};
+
+template <
+  typename TTable, std::size_t Width,
+  typename = typename type_list_impl::make_index_pack<TTable::size>::type
+>
+struct perfect_hash_keys;
+
+template <typename TTable, std::size_t Width, std::size_t... Indexes>
+struct perfect_hash_keys<
+  TTable, Width, type_list_impl::index_pack<Indexes...>
+> {
+  typedef perfect_hash_params<TTable, Width> params;
+
+  static constexpr std::uint64_t hash[sizeof...(Indexes)] = {
+    params::hash(Indexes)...
+  };
+
+  static constexpr std::size_t bucket[sizeof...(Indexes)] = {
+    hash_bucket(params::hash(Indexes), params::bucket_bits)...
+  };
+
+  // whether the hash of the key at `index` differs from the hashes of the
+  // keys in `[begin, end)`
+  static constexpr bool unique(
+    std::size_t index, std::size_t begin, std::size_t end
+  ) {
+    return end - begin < 2
+      ? !(begin < end && hash[index] == hash[begin])
+      : unique(index, begin, begin + (end - begin) / 2)
+        && unique(index, begin + (end - begin) / 2, end);
+  }
+
+  // whether all keys in `[begin, end)` have distinct hashes
+  static constexpr bool distinct(std::size_t begin, std::size_t end) {
+    return end - begin < 2
+      ? !(begin < end) || unique(begin, begin + 1, sizeof...(Indexes))
+      : distinct(begin, begin + (end - begin) / 2)
+        && distinct(begin + (end - begin) / 2, end);
+  }
+};
+
+template <typename TTable, std::size_t Width, std::size_t... Indexes>
+constexpr std::uint64_t perfect_hash_keys<
+  TTable, Width, type_list_impl::index_pack<Indexes...>
+>::hash[sizeof...(Indexes)];
+
+template <typename TTable, std::size_t Width, std::size_t... Indexes>
+constexpr std::size_t perfect_hash_keys<
+  TTable, Width, type_list_impl::index_pack<Indexes...>
+>::bucket[sizeof...(Indexes)];
+
+constexpr std::size_t hash_max(std::size_t lhs, std::size_t rhs) {
+  return lhs < rhs ? rhs : lhs;
+}
+
+// the length of the longest string in `[begin, end)`
+template <typename TTable>
+constexpr std::size_t hash_max_length(std::size_t begin, std::size_t end) {
+  return end - begin < 2
+    ? (begin < end ? TTable::length(begin) : 0)
+    : hash_max(
+      hash_max_length<TTable>(begin, begin + (end - begin) / 2),
+      hash_max_length<TTable>(begin + (end - begin) / 2, end)
+    );
+}
+
+// hashing every character is the bulk of the cost of a lookup, so only as
+// many characters from each end of the string are hashed as needed to tell
+// all strings in the table apart
+template <
+  typename TTable, std::size_t Width = 1,
+  bool = perfect_hash_keys<TTable, Width>::distinct(0, TTable::size)
+    || Width >= hash_max_length<TTable>(0, TTable::size)
+>
+struct perfect_hash_width:
+  public perfect_hash_width<TTable, Width * 2>
+{};
+
+template <typename TTable, std::size_t Width>
+struct perfect_hash_width<TTable, Width, true> {
+  typedef perfect_hash_keys<TTable, Width> type;
+};
+
+// the amount of keys in `[begin, end)` whose bucket is either less than, or
+// equal to, the given one - the range is split in halves so that the depth of
+// the recursion is logarithmic
+template <typename TKeys>
+constexpr std::size_t perfect_hash_count(
+  std::size_t bucket, bool equal, std::size_t begin, std::size_t end
+) {
+  return end - begin < 2
+    ? begin < end && (
+      equal
+        ? TKeys::bucket[begin] == bucket
+        : TKeys::bucket[begin] < bucket
+    )
+    : perfect_hash_count<TKeys>(
+        bucket, equal, begin, begin + (end - begin) / 2
+      )
+      + perfect_hash_count<TKeys>(
+        bucket, equal, begin + (end - begin) / 2, end
+      );
+}
+
+// where the keys for each bucket start in the list of keys grouped by bucket
+template <
+  typename TKeys,
+  typename = typename type_list_impl::make_index_pack<
+    TKeys::params::buckets + 1
+  >::type
+>
+struct perfect_hash_starts;
+
+template <typename TKeys, std::size_t... Buckets>
+struct perfect_hash_starts<TKeys, type_list_impl::index_pack<Buckets...>> {
+  static constexpr std::size_t data[sizeof...(Buckets)] = {
+    perfect_hash_count<TKeys>(Buckets, false, 0, TKeys::params::size)...
+  };
+};
+
+template <typename TKeys, std::size_t... Buckets>
+constexpr std::size_t perfect_hash_starts<
+  TKeys, type_list_impl::index_pack<Buckets...>
+>::data[sizeof...(Buckets)];
+
+// the position of each key in the list of keys grouped by bucket
+template <
+  typename TKeys,
+  typename = typename type_list_impl::make_index_pack<TKeys::params::size>::type
+>
+struct perfect_hash_positions;
+
+template <typename TKeys, std::size_t... Indexes>
+struct perfect_hash_positions<TKeys, type_list_impl::index_pack<Indexes...>> {
+  static constexpr std::size_t data[sizeof...(Indexes)] = {
+    (
+      perfect_hash_starts<TKeys>::data[TKeys::bucket[Indexes]]
+        + perfect_hash_count<TKeys>(TKeys::bucket[Indexes], true, 0, Indexes)
+    )...
+  };
+};
+
+template <typename TKeys, std::size_t... Indexes>
+constexpr std::size_t perfect_hash_positions<
+  TKeys, type_list_impl::index_pack<Indexes...>
+>::data[sizeof...(Indexes)];
+
+// groups the keys by bucket - the positions are computed first, and only
+// then inverted, so that each is computed exactly once
+template <
+  typename TKeys,
+  typename = typename type_list_impl::make_index_pack<TKeys::params::size>::type
+>
+struct perfect_hash_groups;
+
+template <typename TKeys, std::size_t... Positions>
+struct perfect_hash_groups<TKeys, type_list_impl::index_pack<Positions...>> {
+  typedef TKeys keys;
+  typedef perfect_hash_starts<TKeys> starts;
+  typedef perfect_hash_positions<TKeys> positions;
+
+  static constexpr std::size_t either(std::size_t lhs, std::size_t rhs) {
+    return lhs != TKeys::params::size ? lhs : rhs;
+  }
+
+  // the key at the given position of the list of keys grouped by bucket
+  static constexpr std::size_t find(
+    std::size_t position, std::size_t begin, std::size_t end
+  ) {
+    return end - begin < 2
+      ? (begin < end && positions::data[begin] == position
+        ? begin
+        : TKeys::params::size
+      )
+      : either(
+        find(position, begin, begin + (end - begin) / 2),
+        find(position, begin + (end - begin) / 2, end)
+      );
+  }
+
+  static constexpr std::size_t key[sizeof...(Positions)] = {
+    find(Positions, 0, TKeys::params::size)...
+  };
+};
+
+template <typename TKeys, std::size_t... Positions>
+constexpr std::size_t perfect_hash_groups<
+  TKeys, type_list_impl::index_pack<Positions...>
+>::key[sizeof...(Positions)];
+
+// the displacements of the buckets placed so far - the trailing element
+// avoids zero sized arrays before the first bucket is placed
+template <std::size_t... Displacements>
+struct perfect_hash_displacements {
+  static constexpr std::size_t data[sizeof...(Displacements) + 1] = {
+    Displacements..., 0
+  };
+
+  // buckets yet to be placed are assumed to have no displacement
+  static constexpr std::size_t get(std::size_t bucket) {
+    return data[bucket < sizeof...(Displacements)
+      ? bucket
+      : sizeof...(Displacements)
+    ];
+  }
+};
+
+template <std::size_t... Displacements>
+constexpr std::size_t perfect_hash_displacements<Displacements...>::data[
+  sizeof...(Displacements) + 1
+];
+
+template <typename TGroups>
+struct perfect_hash_slot {
+  static constexpr std::size_t get(
+    std::size_t position, std::size_t displacement
+  ) {
+    return hash_slot(
+      TGroups::keys::hash[TGroups::key[position]],
+      displacement,
+      TGroups::keys::params::slot_bits
+    );
+  }
+};
+
+// the slot of each key in the grouped list, given the displacements of the
+// buckets placed so far - only meaningful for the keys of placed buckets
+template <
+  typename TGroups, typename TDisplacements,
+  typename = typename type_list_impl::make_index_pack<
+    TGroups::keys::params::size
+  >::type
+>
+struct perfect_hash_slots;
+
+template <
+  typename TGroups, typename TDisplacements, std::size_t... Positions
+>
+struct perfect_hash_slots<
+  TGroups, TDisplacements, type_list_impl::index_pack<Positions...>
+> {
+  static constexpr std::size_t data[sizeof...(Positions)] = {
+    perfect_hash_slot<TGroups>::get(
+      Positions,
+      TDisplacements::get(TGroups::keys::bucket[TGroups::key[Positions]])
+    )...
+  };
+};
+
+template <
+  typename TGroups, typename TDisplacements, std::size_t... Positions
+>
+constexpr std::size_t perfect_hash_slots<
+  TGroups, TDisplacements, type_list_impl::index_pack<Positions...>
+>::data[sizeof...(Positions)];
+
+// finds the displacement for the keys in `[begin, end)` of the grouped list,
+// given the slots already taken by the keys in `[0, begin)`, whose buckets
+// have already been placed
+template <typename TGroups, typename TDisplacements>
+struct perfect_hash_displacement {
+  typedef typename TGroups::keys::params params;
+
+  typedef perfect_hash_slots<TGroups, TDisplacements> slots;
+
+  static constexpr std::size_t slot(
+    std::size_t position, std::size_t displacement
+  ) {
+    return perfect_hash_slot<TGroups>::get(position, displacement);
+  }
+
+  static constexpr bool taken(
+    std::size_t slot, std::size_t begin, std::size_t end
+  ) {
+    return end - begin < 2
+      ? begin < end && slots::data[begin] == slot
+      : taken(slot, begin, begin + (end - begin) / 2)
+        || taken(slot, begin + (end - begin) / 2, end);
+  }
+
+  // whether the key at `position` collides with any of the keys in
+  // `[begin, position)` for the given displacement
+  static constexpr bool collides(
+    std::size_t displacement, std::size_t begin, std::size_t position
+  ) {
+    return begin < position && (
+      slot(begin, displacement) == slot(position, displacement)
+        || collides(displacement, begin + 1, position)
+    );
+  }
+
+  static constexpr bool fits(
+    std::size_t displacement,
+    std::size_t begin, std::size_t position, std::size_t end
+  ) {
+    return position == end || (
+      !taken(slot(position, displacement), 0, begin)
+        && !collides(displacement, begin, position)
+        && fits(displacement, begin, position + 1, end)
+    );
+  }
+
+  static constexpr std::size_t find(
+    std::size_t begin, std::size_t end, std::size_t displacement = 0
+  ) {
+    return fits(displacement, begin, begin, end)
+      ? displacement
+      : find(begin, end, displacement + 1);
+  }
+
+  static constexpr std::size_t either(std::size_t lhs, std::size_t rhs) {
+    return lhs != params::size ? lhs : rhs;
+  }
+
+  // the key in `[begin, end)` that owns the given slot, if any
+  static constexpr std::size_t owner(
+    std::size_t slot, std::size_t begin, std::size_t end
+  ) {
+    return end - begin < 2
+      ? (begin < end && slots::data[begin] == slot
+        ? TGroups::key[begin]
+        : params::size
+      )
+      : either(
+        owner(slot, begin, begin + (end - begin) / 2),
+        owner(slot, begin + (end - begin) / 2, end)
+      );
+  }
+};
+
+// places one bucket at a time, in order
+template <
+  typename TGroups, std::size_t Bucket, typename TDisplacements,
+  bool = (Bucket == TGroups::keys::params::buckets)
+>
+struct perfect_hash_placement;
+
+template <
+  typename TGroups, std::size_t Bucket, std::size_t... Displacements
+>
+struct perfect_hash_placement<
+  TGroups, Bucket, perfect_hash_displacements<Displacements...>, false
+> {
+  typedef perfect_hash_displacement<
+    TGroups, perfect_hash_displacements<Displacements...>
+  > impl;
+
+  static constexpr std::size_t displacement = impl::find(
+    TGroups::starts::data[Bucket], TGroups::starts::data[Bucket + 1]
+  );
+
+  typedef typename perfect_hash_placement<
+    TGroups, Bucket + 1,
+    perfect_hash_displacements<Displacements..., displacement>
+  >::type type;
+};
+
+template <typename TGroups, std::size_t Bucket, typename TDisplacements>
+struct perfect_hash_placement<TGroups, Bucket, TDisplacements, true> {
+  typedef TDisplacements type;
+};
+
+template <
+  typename TGroups, typename TIndex,
+  typename TDisplacements = typename perfect_hash_placement<
+    TGroups, 0, perfect_hash_displacements<>
+  >::type,
+  typename = typename type_list_impl::make_index_pack<
+    TGroups::keys::params::slots
+  >::type
+>
+struct perfect_hash_data;
+
+template <
+  typename TGroups, typename TIndex,
+  std::size_t... Displacements, std::size_t... Slots
+>
+struct perfect_hash_data<
+  TGroups, TIndex,
+  perfect_hash_displacements<Displacements...>,
+  type_list_impl::index_pack<Slots...>
+> {
+  typedef perfect_hash_displacement<
+    TGroups, perfect_hash_displacements<Displacements...>
+  > impl;
+
+  // the key owning each slot, or the past-the-end key for empty slots
+  static constexpr TIndex slot[sizeof...(Slots)] = {
+    static_cast<TIndex>(
+      impl::owner(Slots, 0, TGroups::keys::params::size)
+    )...
+  };
+
+  static constexpr TIndex displacement[sizeof...(Displacements)] = {
+    static_cast<TIndex>(Displacements)...
+  };
+};
+
+template <
+  typename TGroups, typename TIndex,
+  std::size_t... Displacements, std::size_t... Slots
+>
+constexpr TIndex perfect_hash_data<
+  TGroups, TIndex,
+  perfect_hash_displacements<Displacements...>,
+  type_list_impl::index_pack<Slots...>
+>::slot[sizeof...(Slots)];
+
+template <
+  typename TGroups, typename TIndex,
+  std::size_t... Displacements, std::size_t... Slots
+>
+constexpr TIndex perfect_hash_data<
+  TGroups, TIndex,
+  perfect_hash_displacements<Displacements...>,
+  type_list_impl::index_pack<Slots...>
+>::displacement[sizeof...(Displacements)];
+
+// a bit set with the lengths of the strings in `[begin, end)`, where the
+// last bit stands for all lengths from 63 on
+template <typename TTable>
+constexpr std::uint64_t hash_length_mask(std::size_t begin, std::size_t end) {
+  return end - begin < 2
+    ? (begin < end
+      ? std::uint64_t(1) << hash_width(TTable::length(begin), 63)
+      : 0
+    )
+    : hash_length_mask<TTable>(begin, begin + (end - begin) / 2)
+      | hash_length_mask<TTable>(begin + (end - begin) / 2, end);
+}
+
+/**
+ * Maps each string of a `string_table` to its index in the table, with a
+ * single string comparison.
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <typename TTable>
+class perfect_hash {
+  typedef typename perfect_hash_width<TTable>::type keys;
+  typedef typename keys::params params;
+  typedef perfect_hash_groups<keys> groups;
+
+  typedef typename std::conditional<
+    (params::size < 0xffff), std::uint16_t, std::uint32_t
+  >::type index_type;
+
+  typedef perfect_hash_data<groups, index_type> data;
+
+  typedef typename TTable::char_type char_type;
+
+  // strings whose length matches none in the table are rejected upfront
+  static constexpr std::uint64_t lengths = hash_length_mask<TTable>(
+    0, TTable::size
+  );
+
+public:
+  /**
+   * Returns the index, in the string table, of the string represented by the
+   * range `[begin, end)`, or `TTable::size` when it's not in the table.
+   *
+   * Strings whose length doesn't match any in the table are rejected without
+   * being looked at. Otherwise, only the length and a few characters from
+   * each end of the string are hashed, after which it is compared against
+   * the single candidate that shares its slot.
+   *
+   * Note: this is a runtime facility.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename TIterator>
+  static std::size_t find(TIterator begin, TIterator end) {
+    auto const length = static_cast<std::size_t>(std::distance(begin, end));
+
+    if (!((lengths >> hash_width(length, 63)) & 1)) {
+      return params::size;
+    }
+
+    auto const width = hash_width(length, params::width);
+
+    std::uint64_t hash = (hash_basis ^ length) * hash_prime;
+
+    auto i = begin;
+    for (auto n = width; n--; ++i) {
+      hash = hash_char(hash, static_cast<char_type>(*i));
+    }
+
+    i = std::next(begin, static_cast<std::ptrdiff_t>(length - width));
+    for (auto n = width; n--; ++i) {
+      hash = hash_char(hash, static_cast<char_type>(*i));
+    }
+
+    std::size_t const index = data::slot[
+      hash_slot(
+        hash,
+        data::displacement[hash_bucket(hash, params::bucket_bits)],
+        params::slot_bits
+      )
+    ];
+
+    if (index == params::size || TTable::length(index) != length) {
+      return params::size;
+    }
+
+    return std::equal(begin, end, TTable::c_str(index)) ? index : params::size;
+  }
+
+  /**
+   * Splits the range `[begin, end)` on `delimiter` and calls `visitor` with
+   * the index, in the string table, of each token, as given by `find()`.
+   *
+   * Returns `false` as soon as a token is not in the table, including empty
+   * ones, `true` otherwise. An empty range has no tokens.
+   *
+   * Note: this is a runtime facility.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename TIterator, typename TVisitor>
+  static bool find_all(
+    TIterator begin, TIterator end, char_type delimiter, TVisitor &&visitor
+  ) {
+    if (begin == end) {
+      return true;
+    }
+
+    for (;;) {
+      auto const token = begin;
+
+      while (begin != end && static_cast<char_type>(*begin) != delimiter) {
+        ++begin;
+      }
+
+      auto const index = find(token, begin);
+
+      if (index == params::size) {
+        return false;
+      }
+
+      visitor(index);
+
+      if (begin == end) {
+        return true;
+      }
+
+      ++begin;
+    }
+  }
+};
+
+template <typename TTable>
+constexpr std::uint64_t perfect_hash<TTable>::lengths;
+
+/////////////////
+// value_index //
+/////////////////
+
+template <typename T>
+constexpr T value_min(T lhs, T rhs) { return rhs < lhs ? rhs : lhs; }
+
+template <typename T>
+constexpr T value_max(T lhs, T rhs) { return lhs < rhs ? rhs : lhs; }
+
+template <typename T, T... Values>
+struct value_bounds {
+  typedef value_table<T, Values...> table;
+
+  static constexpr std::size_t size = sizeof...(Values);
+
+  static constexpr T min(std::size_t begin, std::size_t end) {
+    return end - begin < 2
+      ? table::data[begin]
+      : value_min(
+        min(begin, begin + (end - begin) / 2),
+        min(begin + (end - begin) / 2, end)
+      );
+  }
+
+  static constexpr T max(std::size_t begin, std::size_t end) {
+    return end - begin < 2
+      ? table::data[begin]
+      : value_max(
+        max(begin, begin + (end - begin) / 2),
+        max(begin + (end - begin) / 2, end)
+      );
+  }
+
+  static constexpr std::uintmax_t first = as_uint(min(0, size));
+
+  // the distance between the smallest and the largest values
+  static constexpr std::uintmax_t span = as_uint(max(0, size)) - first;
+
+  // the distance of `value` from the smallest value - modular arithmetic
+  // makes values out of bounds, on either side, yield more than `span`
+  static constexpr std::uintmax_t offset(T value) {
+    return as_uint(value) - first;
+  }
+
+  // the bits of the given 64 bit word of a bitmap with one bit set for the
+  // offset of each value in `[begin, end)`
+  static constexpr std::uint64_t word(
+    std::size_t which, std::size_t begin, std::size_t end
+  ) {
+    return end - begin < 2
+      ? (begin < end && offset(table::data[begin]) / 64 == which
+        ? std::uint64_t(1) << (offset(table::data[begin]) % 64)
+        : 0
+      )
+      : word(which, begin, begin + (end - begin) / 2)
+        | word(which, begin + (end - begin) / 2, end);
+  }
+
+  static constexpr std::size_t either(std::size_t lhs, std::size_t rhs) {
+    return lhs != size ? lhs : rhs;
+  }
+
+  // whether the value at `index` differs from the values in `[begin, end)`
+  static constexpr bool unique(
+    std::size_t index, std::size_t begin, std::size_t end
+  ) {
+    return end - begin < 2
+      ? !(begin < end && table::data[index] == table::data[begin])
+      : unique(index, begin, begin + (end - begin) / 2)
+        && unique(index, begin + (end - begin) / 2, end);
+  }
+
+  // whether all values in `[begin, end)` are distinct
+  static constexpr bool distinct(std::size_t begin, std::size_t end) {
+    return end - begin < 2
+      ? !(begin < end) || unique(begin, begin + 1, size)
+      : distinct(begin, begin + (end - begin) / 2)
+        && distinct(begin + (end - begin) / 2, end);
+  }
+
+  // the index of the value in `[begin, end)` with the given offset, if any
+  static constexpr std::size_t find(
+    std::uintmax_t offset, std::size_t begin, std::size_t end
+  ) {
+    return end - begin < 2
+      ? (begin < end && value_bounds::offset(table::data[begin]) == offset
+        ? begin
+        : size
+      )
+      : either(
+        find(offset, begin, begin + (end - begin) / 2),
+        find(offset, begin + (end - begin) / 2, end)
+      );
+  }
+};
+
+template <typename T, T... Values>
+constexpr std::uintmax_t value_bounds<T, Values...>::first;
+
+template <typename T, T... Values>
+constexpr std::uintmax_t value_bounds<T, Values...>::span;
+
+template <std::size_t Size>
+using value_index_type = typename std::conditional<
+  (Size < 0xff),
+  std::uint8_t,
+  typename std::conditional<
+    (Size < 0xffff), std::uint16_t, std::uint32_t
+  >::type
+>::type;
+
+// a bitmap with a bit set for the offset of each value, along with the index
+// of the value for each offset in the range
+template <
+  typename TBounds,
+  typename = typename type_list_impl::make_index_pack<
+    static_cast<std::size_t>(TBounds::span / 64 + 1)
+  >::type,
+  typename = typename type_list_impl::make_index_pack<
+    static_cast<std::size_t>(TBounds::span + 1)
+  >::type
+>
+struct value_lookup;
+
+template <
+  typename TBounds, std::size_t... Words, std::size_t... Offsets
+>
+struct value_lookup<
+  TBounds,
+  type_list_impl::index_pack<Words...>,
+  type_list_impl::index_pack<Offsets...>
+> {
+  typedef value_index_type<TBounds::size> index_type;
+
+  static constexpr std::uint64_t bits[sizeof...(Words)] = {
+    TBounds::word(Words, 0, TBounds::size)...
+  };
+
+  static constexpr index_type index[sizeof...(Offsets)] = {
+    static_cast<index_type>(TBounds::find(Offsets, 0, TBounds::size))...
+  };
+};
+
+template <
+  typename TBounds, std::size_t... Words, std::size_t... Offsets
+>
+constexpr std::uint64_t value_lookup<
+  TBounds,
+  type_list_impl::index_pack<Words...>,
+  type_list_impl::index_pack<Offsets...>
+>::bits[sizeof...(Words)];
+
+template <
+  typename TBounds, std::size_t... Words, std::size_t... Offsets
+>
+constexpr typename value_lookup<
+  TBounds,
+  type_list_impl::index_pack<Words...>,
+  type_list_impl::index_pack<Offsets...>
+>::index_type value_lookup<
+  TBounds,
+  type_list_impl::index_pack<Words...>,
+  type_list_impl::index_pack<Offsets...>
+>::index[sizeof...(Offsets)];
+
+// the keys of a perfect hash over the values themselves, used as their own
+// hashes - the values must be distinct, otherwise no perfect hash exists
+template <typename T, T... Values>
+struct value_hash_keys {
+  typedef perfect_hash_layout<sizeof...(Values)> params;
+
+  static constexpr std::uint64_t hash[sizeof...(Values)] = {
+    as_uint(Values)...
+  };
+
+  static constexpr std::size_t bucket[sizeof...(Values)] = {
+    hash_bucket(as_uint(Values), params::bucket_bits)...
+  };
+};
+
+template <typename T, T... Values>
+constexpr std::uint64_t value_hash_keys<T, Values...>::hash[
+  sizeof...(Values)
+];
+
+template <typename T, T... Values>
+constexpr std::size_t value_hash_keys<T, Values...>::bucket[
+  sizeof...(Values)
+];
+
+// the lookup tables cost about one byte per offset in the range of the values
+// while the perfect hash costs a few bytes per value, hence the former is only
+// used when the values are not too sparse
+template <
+  typename TBounds,
+  bool Dense,
+  bool Small = (TBounds::span < hash_max(64, TBounds::size * 8))
+>
+struct value_index_impl;
+
+// contiguous values in ascending order: the offset is the index
+template <typename T, T... Values, bool Small>
+struct value_index_impl<value_bounds<T, Values...>, true, Small> {
+  typedef value_bounds<T, Values...> bounds;
+
+  static bool is_valid(T value) {
+    return bounds::offset(value) < bounds::size;
+  }
+
+  static std::size_t index_of(T value) {
+    auto const offset = bounds::offset(value);
+    return offset < bounds::size
+      ? static_cast<std::size_t>(offset)
+      : bounds::size;
+  }
+};
+
+// values in a small range: a bitmap tells valid values apart, while a table
+// maps offsets to indexes
+template <typename T, T... Values>
+struct value_index_impl<value_bounds<T, Values...>, false, true> {
+  typedef value_bounds<T, Values...> bounds;
+
+  static_assert(
+    bounds::distinct(0, bounds::size),
+    "duplicate enum values are not supported"
+  );
+
+  typedef value_lookup<bounds> lookup;
+
+  static bool is_valid(T value) {
+    auto const offset = bounds::offset(value);
+    return offset <= bounds::span
+      && ((lookup::bits[offset / 64] >> (offset % 64)) & 1);
+  }
+
+  static std::size_t index_of(T value) {
+    auto const offset = bounds::offset(value);
+    return offset <= bounds::span ? lookup::index[offset] : bounds::size;
+  }
+};
+
+// sparse values: a perfect hash yields the only candidate index, which is
+// then checked against the value table
+template <typename T, T... Values>
+struct value_index_impl<value_bounds<T, Values...>, false, false> {
+  typedef value_bounds<T, Values...> bounds;
+
+  static_assert(
+    bounds::distinct(0, bounds::size),
+    "duplicate enum values are not supported"
+  );
+
+  // no perfect hash exists for duplicate values, in which case a placeholder
+  // keeps the assertion above as the only error
+  typedef typename std::conditional<
+    bounds::distinct(0, bounds::size),
+    value_hash_keys<T, Values...>,
+    value_hash_keys<T, static_cast<T>(0)>
+  >::type keys;
+  typedef typename keys::params params;
+  typedef perfect_hash_data<
+    perfect_hash_groups<keys>, value_index_type<params::size>
+  > data;
+
+  static std::size_t index_of(T value) {
+    auto const hash = as_uint(value);
+
+    std::size_t const index = data::slot[
+      hash_slot(
+        hash,
+        data::displacement[hash_bucket(hash, params::bucket_bits)],
+        params::slot_bits
+      )
+    ];
+
+    return index != params::size && bounds::table::data[index] == value
+      ? index
+      : params::size;
+  }
+
+  static bool is_valid(T value) {
+    return index_of(value) != params::size;
+  }
+};
+
+/**
+ * Maps each value to its index in the declaration order, and tells whether
+ * an arbitrary value is one of them, in constant time and without a switch
+ * over the values.
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <typename T, T... Values>
+using value_index = value_index_impl<
+  value_bounds<T, Values...>,
+  is_dense<T, Values...>::value
+>;
+
+} // namespace enum_impl {
+} // namespace detail {
+
 /**
  * The code below is dense and not for the faint of heart, stick to comments
  * only and you should be fine. Otherwise, abandon all hope ye who enter here.
@@ -187,8 +1277,6 @@ namespace fatal {
     ) \
   }
 
-#define FATAL_ENUM_TO_STR_CASE_IMPL(Field, Value, Enum, Handler, ...) \
-  case Handler(Value, Enum)::Field: return FB_STRINGIZE(Field);
 #define FATAL_ENUM_TO_CSTR_IMPL(Field, ...) FATAL_STR(Field, FATAL_AS_STR(Field));
 #define FATAL_ENUM_VALUE_TO_LIST_LAST_IMPL(Field, Value, Enum, Handler, ...) \
   Handler(Value, Enum)::Field
@@ -239,12 +1327,44 @@ namespace fatal {
  *      cstr::field0, cstr::field1, cstr::field2, cstr::field3
  *    > prefix_tree;
  *
+ *    // a single contiguous pool with the null-terminated names of all fields,
+ *    // in declaration order: "field0\0field1\0field2\0field3\0"
+ *    // `string_table::c_str(i)` and `string_table::length(i)` return the
+ *    // name of the i-th field and its length, using a table of offsets into
+ *    // the pool
+ *    struct string_table;
+ *
+ *    // a perfect hash, computed at compile time, which maps the name of each
+ *    // field to its position in `string_table`
+ *    struct perfect_hash;
+ *
+ *    // a set of flags with one flag per field, in declaration order, whose
+ *    // tags are `std::integral_constant<Enum, Enum::field>`
+ *    typedef flag_set<
+ *      std::integral_constant<Enum, Enum::field0>,
+ *      std::integral_constant<Enum, Enum::field1>,
+ *      std::integral_constant<Enum, Enum::field2>,
+ *      std::integral_constant<Enum, Enum::field3>
+ *    > flags;
+ *
  *    // returns the string representation of `e`, or
  *    // `nullptr` if `e` is not a valid enum value
  *    // note: the caller doesn't own the string returned,
  *    // nor does it need to deallocate it
  *    char const *to_str(Enum e);
  *
+ *    // same as `to_str()` but also returns the length of the string,
+ *    // or `{nullptr, 0}` if `e` is not a valid enum value
+ *    std::pair<char const *, std::size_t> to_str_with_length(Enum e);
+ *
+ *    // returns the position of `e` in the declaration order of the
+ *    // enum's fields, or `strings::size` if `e` is not a valid enum value
+ *    static std::size_t index_of(Enum e);
+ *
+ *    // tells whether `value`, say one read from the wire, corresponds to
+ *    // one of the enum's fields
+ *    static bool is_valid(std::underlying_type<Enum>::type value);
+ *
  *    // if the string represented by iterators `begin` and
  *    // `end` represents a valid enum value, returns it
  *    // otherwise, throws `std::invalid_argument`
@@ -266,13 +1386,77 @@ namespace fatal {
  *    // and `std::end(s)` for the iterators
  *    template <typename TString>
  *    bool try_parse(Enum &out, TString const &s);
+ *
+ *    // parses a list of field names separated by `delimiter`, as in
+ *    // "field0|field2", setting `out` to the set of flags of those fields or,
+ *    // when `out` is an integer, to the bitwise or of their values
+ *    // returns `true` on success, otherwise returns `false` and leaves `out`
+ *    // untouched - an empty string yields an empty set of flags
+ *    // the string is split in a single pass, without allocating memory
+ *    template <typename TIterator>
+ *    bool try_parse_flags(
+ *      flags &out, TIterator begin, TIterator end, char delimiter = '|'
+ *    );
+ *    template <typename TIterator>
+ *    bool try_parse_flags(
+ *      std::underlying_type<Enum>::type &out,
+ *      TIterator begin, TIterator end, char delimiter = '|'
+ *    );
+ *
+ *    // same as above, with `std::begin(s)`
+ *    // and `std::end(s)` for the iterators
+ *    template <typename TOut, typename TString>
+ *    bool try_parse_flags(TOut &out, TString const &s, char delimiter = '|');
+ *
+ *    // same as `try_parse_flags()` but returns the set of flags, or throws
+ *    // `std::invalid_argument` if the string can't be parsed
+ *    template <typename TIterator>
+ *    flags parse_flags(TIterator begin, TIterator end, char delimiter = '|');
+ *    template <typename TString>
+ *    flags parse_flags(TString const &s, char delimiter = '|');
+ *
+ *    // appends to `out` the names of the fields whose flag is set in `f`,
+ *    // in declaration order, separated by `delimiter`
+ *    template <typename TString>
+ *    void to_flags_str(TString &out, flags const &f, char delimiter = '|');
+ *
+ *    // appends to `out` the names of the non-zero fields whose bits are all
+ *    // set in `bits`, in declaration order, separated by `delimiter`
+ *    // returns whether every bit set in `bits` belongs to some field
+ *    template <typename TString>
+ *    bool to_flags_str(
+ *      TString &out,
+ *      std::underlying_type<Enum>::type bits,
+ *      char delimiter = '|'
+ *    );
+ *
+ *    // parses every string in `input`, in order, as in `try_parse()`, writing
+ *    // the results through the output iterators `out` and `valid`, the latter
+ *    // receiving whether each string was a valid enum value or not
+ *    // `out` is advanced, but not written to, for invalid strings
+ *    // never throws, and returns the amount of valid strings
+ *    template <typename TInput, typename TOut, typename TValid>
+ *    std::size_t parse_batch(TInput const &input, TOut out, TValid valid);
  *  };
  *
- * `to_str()` complexity is generally O(1) - it's implemented with a
- * straightforward switch/case statement.
+ *  // used to find `ClassName` out of `Enum`, see `enum_str_class`
+ *  ClassName fatal_enum_str_class(Enum);
  *
- * `parse()` and `try_parse()` complexity is `O(m lg k)`, where `m` is the size
- * of the largest enum value name and `k` is the total number of enum values.
+ * `to_str()`, `to_str_with_length()`, `index_of()` and `is_valid()` complexity
+ * is O(1). When the enum values are contiguous and in ascending order, the
+ * position of the field in `string_table` is computed directly out of the
+ * value. When they lie in a small range, a bitmap tells
+ * valid values apart and a table maps them to positions. Otherwise, a perfect
+ * hash built at compile time yields the single candidate position, which is
+ * then checked.
+ *
+ * `parse()` and `try_parse()` complexity is `O(m)`, where `m` is the size of
+ * the string being parsed: strings whose length matches no field name are
+ * rejected upfront, otherwise only their length and a few characters from each
+ * of their ends are hashed, after which they're compared against the single
+ * field name sharing their slot in `perfect_hash`. Since the string is
+ * traversed more than once, `begin` and `end` must be at least forward
+ * iterators. The same holds for each string given to `parse_batch()`.
  *
  * @author: Marcelo Juchem <marcelo@fb.com>
  */
@@ -308,39 +1492,37 @@ namespace fatal {
     typedef strings::apply< \
       ::fatal::type_prefix_tree_builder<>::build \
     > prefix_tree; \
+    typedef strings::apply< \
+      ::fatal::detail::enum_impl::string_table \
+    > string_table; \
+    typedef ::fatal::detail::enum_impl::perfect_hash<string_table> \
+      perfect_hash; \
+    typedef values::list::apply< ::fatal::flag_set> flags; \
   private: \
-    struct parse_visitor_impl { \
-      template <typename TString> \
-      void operator ()(type_tag<TString>, Enum &out) { \
-        typedef typename str_to_value::template find<TString> value; \
-        static_assert( \
-          !::std::is_same<value, ::fatal::type_not_found_tag>::value, \
-          "missing enum mapping" \
-        ); \
-        out = value::value; \
-      } \
-    }; \
+    typedef values::typed_apply< \
+      ::fatal::detail::enum_impl::value_index \
+    > value_index; \
   public: \
+    static std::size_t index_of(Enum e) { return value_index::index_of(e); } \
+    static bool is_valid(::std::underlying_type<Enum>::type value) { \
+      return value_index::is_valid(static_cast<Enum>(value)); \
+    } \
     static char const *to_str(Enum e) { \
-      switch (e) { \
-        default: return nullptr; \
-        ENUMIFY_FN( \
-          FATAL_ENUM_TO_STR_CASE_IMPL, \
-          FATAL_ENUM_TO_STR_CASE_IMPL, \
-          FATAL_ENUM_TO_STR_CASE_IMPL, \
-          Enum, \
-          FATAL_ENUMIFY_GET_2ND_ARG, \
-          FATAL_ENUMIFY_GET_1ST_ARG \
-        ) \
-      } \
+      auto const i = index_of(e); \
+      return i < string_table::size ? string_table::c_str(i) : nullptr; \
+    } \
+    static ::std::pair<char const *, ::std::size_t> to_str_with_length( \
+      Enum e \
+    ) { \
+      auto const i = index_of(e); \
+      return i < string_table::size \
+        ? ::std::make_pair(string_table::c_str(i), string_table::length(i)) \
+        : ::std::pair<char const *, ::std::size_t>(nullptr, 0); \
     } \
     template <typename TBegin, typename TEnd> \
     static Enum parse(TBegin &&begin, TEnd &&end) { \
       Enum out; \
-      if (!prefix_tree::match<>::exact( \
-        std::forward<TBegin>(begin), std::forward<TEnd>(end), \
-        parse_visitor_impl{}, out \
-      )) { \
+      if (!try_parse(out, begin, end)) { \
         throw std::invalid_argument("unrecognized enum value"); \
       } \
       return out; \
@@ -351,16 +1533,134 @@ namespace fatal {
     } \
     template <typename TBegin, typename TEnd> \
     static bool try_parse(Enum &out, TBegin &&begin, TEnd &&end) { \
-      return prefix_tree::match<>::exact( \
-        std::forward<TBegin>(begin), std::forward<TEnd>(end), \
-        parse_visitor_impl{}, out \
-      ); \
+      auto const i = perfect_hash::find(begin, end); \
+      if (i == strings::size) { \
+        return false; \
+      } \
+      out = values::typed_apply< \
+        ::fatal::detail::enum_impl::value_table \
+      >::data[i]; \
+      return true; \
     } \
     template <typename TString> \
     static bool try_parse(Enum &out, TString const &s) { \
       return try_parse(out, std::begin(s), std::end(s)); \
     } \
-  } \
+    template <typename TIterator> \
+    static bool try_parse_flags( \
+      flags &out, TIterator begin, TIterator end, char delimiter = '|' \
+    ) { \
+      flags bits; \
+      if (!perfect_hash::find_all(begin, end, delimiter, \
+        [&bits](std::size_t i) { bits.set_at(i); } \
+      )) { \
+        return false; \
+      } \
+      out = bits; \
+      return true; \
+    } \
+    template <typename TIterator> \
+    static bool try_parse_flags( \
+      ::std::underlying_type<Enum>::type &out, \
+      TIterator begin, TIterator end, char delimiter = '|' \
+    ) { \
+      ::std::underlying_type<Enum>::type bits = 0; \
+      if (!perfect_hash::find_all(begin, end, delimiter, \
+        [&bits](std::size_t i) { \
+          bits |= static_cast< ::std::underlying_type<Enum>::type>( \
+            values::typed_apply< \
+              ::fatal::detail::enum_impl::value_table \
+            >::data[i] \
+          ); \
+        } \
+      )) { \
+        return false; \
+      } \
+      out = bits; \
+      return true; \
+    } \
+    template <typename TOut, typename TString> \
+    static bool try_parse_flags( \
+      TOut &out, TString const &s, char delimiter = '|' \
+    ) { \
+      return try_parse_flags(out, std::begin(s), std::end(s), delimiter); \
+    } \
+    template <typename TIterator> \
+    static flags parse_flags( \
+      TIterator begin, TIterator end, char delimiter = '|' \
+    ) { \
+      flags out; \
+      if (!try_parse_flags(out, begin, end, delimiter)) { \
+        throw std::invalid_argument("unrecognized enum flags"); \
+      } \
+      return out; \
+    } \
+    template <typename TString> \
+    static flags parse_flags(TString const &s, char delimiter = '|') { \
+      return parse_flags(std::begin(s), std::end(s), delimiter); \
+    } \
+    template <typename TString> \
+    static void to_flags_str( \
+      TString &out, flags const &f, char delimiter = '|' \
+    ) { \
+      bool first = true; \
+      for (std::size_t i = 0; i < string_table::size; ++i) { \
+        if (f.is_set_at(i)) { \
+          if (!first) { \
+            out.push_back(delimiter); \
+          } \
+          out.append(string_table::c_str(i), string_table::length(i)); \
+          first = false; \
+        } \
+      } \
+    } \
+    template <typename TString> \
+    static bool to_flags_str( \
+      TString &out, \
+      ::std::underlying_type<Enum>::type bits, \
+      char delimiter = '|' \
+    ) { \
+      bool first = true; \
+      ::std::underlying_type<Enum>::type covered = 0; \
+      for (std::size_t i = 0; i < string_table::size; ++i) { \
+        auto const value = static_cast< ::std::underlying_type<Enum>::type>( \
+          values::typed_apply< \
+            ::fatal::detail::enum_impl::value_table \
+          >::data[i] \
+        ); \
+        if (value && (bits & value) == value) { \
+          if (!first) { \
+            out.push_back(delimiter); \
+          } \
+          out.append(string_table::c_str(i), string_table::length(i)); \
+          covered |= value; \
+          first = false; \
+        } \
+      } \
+      return covered == bits; \
+    } \
+    template <typename TInput, typename TOut, typename TValid> \
+    static std::size_t parse_batch( \
+      TInput const &input, TOut out, TValid valid \
+    ) { \
+      std::size_t count = 0; \
+      for (auto const &s: input) { \
+        auto const i = perfect_hash::find(std::begin(s), std::end(s)); \
+        auto const found = i != strings::size; \
+        if (found) { \
+          *out = values::typed_apply< \
+            ::fatal::detail::enum_impl::value_table \
+          >::data[i]; \
+        } \
+        *valid = found; \
+        count += found; \
+        ++out; \
+        ++valid; \
+      } \
+      return count; \
+    } \
+  }; \
+  ClassName fatal_enum_str_class(Enum) \
 
 /**
  * A convenience macro that combines both `FATAL_DECLARE_ENUM` and
@@ -372,4 +1672,24 @@ namespace fatal {
   FATAL_DECLARE_ENUM(Enum, ENUMIFY_FN); \
   FATAL_DEFINE_ENUM_STR_CLASS(Enum, ClassName, ENUMIFY_FN) \
 
+/**
+ * Resolves to the class created by `FATAL_DEFINE_ENUM_STR_CLASS` for the
+ * given enum.
+ *
+ * The class is found through argument dependent lookup, by means of a
+ * function declared along with it, so both the enum and the class must be
+ * declared at namespace scope.
+ *
+ * Example:
+ *
+ *  FATAL_RICH_ENUM(my_enum, my_enum_str, ENUMIFY_MY_ENUM);
+ *
+ *  // yields `my_enum_str`
+ *  typedef enum_str_class<my_enum> result;
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <typename Enum>
+using enum_str_class = decltype(fatal_enum_str_class(std::declval<Enum>()));
+
 } // namespace fatal
@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <fatal/math/numerics.h>
 #include <fatal/type/list.h>
 #include <fatal/type/pair.h>
 #include <fatal/type/tag.h>
@@ -148,6 +149,66 @@ struct cluster<T, Args...> {
   >::type type;
 };
 
+//////////
+// find //
+//////////
+
+template <typename> struct key_entry {};
+
+// the index tells apart pairs with the same key, which would otherwise be
+// repeated bases
+template <std::size_t, typename TKey, typename TMapped>
+struct find_entry: public key_entry<TKey> {};
+
+template <typename, typename...> struct find_set;
+
+// looking up a key in this set is a single overload resolution rather than a
+// recursive scan over the map
+template <std::size_t... Indexes, typename... Args>
+struct find_set<type_list_impl::index_pack<Indexes...>, Args...>:
+  public find_entry<Indexes, typename Args::first, typename Args::second>...
+{};
+
+template <typename TKey, std::size_t Index, typename TMapped>
+type_pair<std::true_type, TMapped> find_pick(
+  find_entry<Index, TKey, TMapped> const *
+);
+
+// picked when `TKey` is not in the set, or when it's there more than once
+template <typename>
+type_pair<std::false_type, void> find_pick(...);
+
+template <typename T>
+struct find_identity { typedef T type; };
+
+// used when the key appears more than once since the overload resolution
+// above is ambiguous, and the first pair with that key must be returned
+template <typename TKey, typename TDefault, typename... Args>
+struct find_linear {
+  typedef typename type_list_impl::search<
+    curried_key_filter<std::is_same, TKey>::template type,
+    type_pair<void, TDefault>,
+    Args...
+  >::type::second type;
+};
+
+template <typename TSet, typename TKey, typename TDefault, typename... Args>
+struct find {
+  typedef decltype(
+    find_pick<TKey>(static_cast<TSet const *>(nullptr))
+  ) unique;
+
+  typedef typename std::conditional<
+    unique::first::value,
+    find_identity<typename unique::second>,
+    typename std::conditional<
+      std::is_base_of<key_entry<TKey>, TSet>::value,
+      find_linear<TKey, TDefault, Args...>,
+      find_identity<TDefault>
+    >::type
+  >::type::type type;
+};
+
 ///////////
 // visit //
 ///////////
@@ -178,6 +239,13 @@ struct visit_visitor<TKey, visit_not_found> {
 
 template <typename TComparer>
 struct binary_search_comparer {
+  // the key exposed by `TComparer` for the pair's key, used by
+  // `type_map::lookup` - yields `void` when `TComparer` exposes none
+  template <typename T, std::size_t Index>
+  using key = typename type_list_impl::lookup_key<
+    TComparer, typename T::first, Index
+  >::type;
+
   template <typename TNeedle, typename TKey, typename TValue, std::size_t Index>
   static constexpr int compare(
     TNeedle &&needle,
@@ -190,6 +258,120 @@ struct binary_search_comparer {
   }
 };
 
+///////////////////
+// mapped_lookup //
+///////////////////
+
+// adapts `binary_search` to the `mapped_lookup` visitor contract
+template <typename TMappedSet>
+struct mapped_lookup_visitor {
+  template <
+    typename TKey, typename TMapped, std::size_t Index,
+    typename TNeedle, typename TVisitor, typename... VArgs
+  >
+  void operator ()(
+    indexed_type_tag<type_pair<TKey, TMapped>, Index>,
+    TNeedle &&needle,
+    TVisitor &&visitor,
+    VArgs &&...args
+  ) const {
+    visitor(
+      indexed_type_tag<
+        TMapped,
+        TMappedSet::template index_of<TMapped>::value
+      >(),
+      std::forward<TNeedle>(needle),
+      std::forward<VArgs>(args)...
+    );
+  }
+};
+
+template <bool, typename, typename, typename, typename...>
+struct mapped_lookup_impl;
+
+// keys that aren't sorted integral constants, or needles that aren't
+// integral, are searched with `binary_search`, which instantiates the
+// visitor once per key
+template <
+  typename TComparer, typename TMappedSet, typename TIndexes, typename... Args
+>
+struct mapped_lookup_impl<false, TComparer, TMappedSet, TIndexes, Args...> {
+  template <typename TNeedle, typename TVisitor, typename... VArgs>
+  static bool exact(TNeedle &&needle, TVisitor &&visitor, VArgs &&...args) {
+    return type_list<Args...>::template binary_search<
+      binary_search_comparer<TComparer>
+    >::exact(
+      std::forward<TNeedle>(needle),
+      mapped_lookup_visitor<TMappedSet>(),
+      std::forward<TVisitor>(visitor),
+      std::forward<VArgs>(args)...
+    );
+  }
+};
+
+// the keys and, for each of them, the index of its mapped type in
+// `TMappedSet` are stored in two parallel static arrays, so that the visitor
+// is only instantiated once per distinct mapped type
+template <
+  typename TComparer, typename TMappedSet,
+  std::size_t... Indexes, typename... Args
+>
+struct mapped_lookup_impl<
+  true, TComparer, TMappedSet, type_list_impl::index_pack<Indexes...>, Args...
+> {
+  typedef typename type_list_impl::lookup_range<
+    typename binary_search_comparer<TComparer>::template key<Args, Indexes>...
+  >::type key_type;
+
+  typedef type_list_impl::lookup_array<
+    key_type,
+    static_cast<key_type>(
+      binary_search_comparer<TComparer>::template key<Args, Indexes>::value
+    )...
+  > keys;
+
+  typedef smallest_uint_for_value<TMappedSet::size> index_type;
+
+  typedef type_list_impl::lookup_array<
+    index_type,
+    static_cast<index_type>(
+      TMappedSet::template index_of<typename Args::second>::value
+    )...
+  > mapped;
+
+  template <typename TNeedle, typename TVisitor, typename... VArgs>
+  static bool exact(TNeedle &&needle, TVisitor &&visitor, VArgs &&...args) {
+    auto const i = keys::search(needle);
+
+    return keys::data[i] == needle && TMappedSet::visit(
+      mapped::data[i],
+      std::forward<TVisitor>(visitor),
+      std::forward<TNeedle>(needle),
+      std::forward<VArgs>(args)...
+    );
+  }
+};
+
+template <typename TComparer, typename TIndexes, typename... Args>
+struct mapped_lookup_select;
+
+template <typename TComparer, std::size_t... Indexes, typename... Args>
+struct mapped_lookup_select<
+  TComparer, type_list_impl::index_pack<Indexes...>, Args...
+>:
+  public type_list_impl::is_lookup_friendly<
+    sizeof...(Args) != 0
+      && type_list_impl::all_of<
+        type_list_impl::is_integral_key<
+          typename binary_search_comparer<TComparer>::template key<
+            Args, Indexes
+          >
+        >::value...
+      >::value,
+    typename binary_search_comparer<TComparer>::template key<Args, Indexes>...
+  >
+{};
+
 } // namespace type_map_impl {
 } // namespace detail {
 
@@ -206,9 +388,8 @@ struct binary_search_comparer {
 template <typename... Args>
 class type_map {
   static_assert(
-    logical_and_constants<
-      std::true_type,
-      is_template<type_pair>::template instantiation<Args>...
+    detail::type_list_impl::all_of<
+      is_template<type_pair>::template instantiation<Args>::value...
     >::value,
     "type_map elements must be instantiations of type_pair"
   );
@@ -216,6 +397,12 @@ class type_map {
   // private to `type_map` so that `contains` will never have false negatives
   struct not_found_tag_impl {};
 
+  // backs `find` and `contains`, only instantiated when they're used
+  typedef detail::type_map_impl::find_set<
+    typename detail::type_list_impl::make_index_pack<sizeof...(Args)>::type,
+    Args...
+  > find_set;
+
 public:
   /**
    * The underlying type_list of type_pair<TKey, TMapped> used for
@@ -312,6 +499,9 @@ public:
    * If there's no pair in this map with key `TKey` then `TDefault` is returned
    * (defaults to `type_not_found_tag` when omitted).
    *
+   * The key is looked up with a single overload resolution rather than by
+   * scanning the map, unless it appears in more than one pair.
+   *
    * Example:
    *
    *  typedef type_map<type_pair<int, double>, type_pair<bool, long>> map;
@@ -326,16 +516,15 @@ public:
    *  typedef map::find<float, void> result2;
    */
   template <typename TKey, typename TDefault = type_not_found_tag>
-  using find = typename contents::template search<
-    detail::type_map_impl::curried_key_filter<
-      std::is_same, TKey
-    >::template type,
-    type_pair<void, TDefault>
-  >::second;
+  using find = typename detail::type_map_impl::find<
+    find_set, TKey, TDefault, Args...
+  >::type;
 
   /**
    * Tells whether there is a mapping where T is the key.
    *
+   * Checked with a single `std::is_base_of`, without scanning the map.
+   *
    * Example:
    *
    *  typedef type_map<type_pair<int, double>> map;
@@ -347,7 +536,10 @@ public:
    *  map::contains<bool>::value
    */
   template <typename T>
-  using contains = typename keys::template contains<T>;
+  using contains = std::integral_constant<
+    bool,
+    std::is_base_of<detail::type_map_impl::key_entry<T>, find_set>::value
+  >;
 
   /**
    * Inserts the given `TKey` and `TValue` pair before all elements of this map.
@@ -898,6 +1090,157 @@ public:
       );
     }
   };
+
+  /**
+   * Searches for a key that is an exact match of the `needle`, with the same
+   * contract as `binary_search<TComparer>::exact`, but choosing the best
+   * search strategy for this map at compile time.
+   *
+   * This is the map counterpart of `type_list::lookup`, with the strategy
+   * chosen based on the keys exposed by `TComparer` for this map's keys.
+   * Refer to `type_list::lookup` and `lookup_strategy` for more details.
+   *
+   * Just like `binary_search`, the visitor is instantiated once per key, so
+   * the generated code grows with the amount of keys. Refer to
+   * `mapped_lookup` for large maps where that matters.
+   *
+   * Note: this is a runtime facility.
+   *
+   * Example:
+   *
+   *  struct visitor {
+   *    template <int Key, int Mapped, std::size_t Index>
+   *    void operator ()(
+   *      indexed_type_tag<type_pair<int_val<Key>, int_val<Mapped>>, Index>,
+   *      int needle
+   *    ) {
+   *      assert(needle == Key);
+   *      std::cout << "key " << needle << " found at index " << Index
+   *        << " mapping " << Mapped << std::endl;
+   *    };
+   *  };
+   *
+   *  typedef type_map<
+   *    type_pair<int_val<10>, int_val<100>>,
+   *    type_pair<int_val<30>, int_val<300>>,
+   *    type_pair<int_val<50>, int_val<500>>
+   *  > map;
+   *
+   *  // yields `lookup_strategy::switch_chain`
+   *  map::lookup<>::strategy()
+   *
+   *  // yields `false`
+   *  map::lookup<>::exact(20, visitor());
+   *
+   *  // yields `true` and prints `"key 30 found at index 1 mapping 300"`
+   *  map::lookup<>::exact(30, visitor());
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename TComparer = type_value_comparer>
+  using lookup = typename contents::template lookup<
+    detail::type_map_impl::binary_search_comparer<TComparer>
+  >;
+
+  /**
+   * Searches for a key that is an exact match of the `needle`, like
+   * `lookup<TComparer>::exact`, but only tells the visitor which type the
+   * key maps to, rather than the whole pair.
+   *
+   * If a matching key is found, the visitor is called with the following
+   * arguments:
+   *  - an instance of `indexed_type_tag<Mapped, Index>`, where `Mapped` is
+   *    the mapped type and `Index` is its position in `mapped::unique<>`
+   *  - the needle
+   *  - the list of additional arguments `args` given to `exact()`
+   *
+   * Returns `true` when found, `false` otherwise.
+   *
+   * This is meant for large maps with many keys sharing a few mapped types,
+   * like maps from ids to handlers. When the keys exposed by `TComparer` are
+   * integral constants sorted in ascending order and the needle is integral,
+   * the keys are stored in a static sorted array, searched with a branchless
+   * binary search. A second static array maps each key to the index of its
+   * mapped type, through which the visitor is dispatched. The visitor is,
+   * therefore, only instantiated once per distinct mapped type, rather than
+   * once per key as with `binary_search` or `lookup`.
+   *
+   * Otherwise, a regular `binary_search` is performed.
+   *
+   * Note: this is a runtime facility.
+   *
+   * Example:
+   *
+   *  struct get_handler {};
+   *  struct put_handler {};
+   *
+   *  struct visitor {
+   *    template <typename THandler, std::size_t Index>
+   *    void operator ()(indexed_type_tag<THandler, Index>, int id) {
+   *      THandler::handle(id);
+   *    };
+   *  };
+   *
+   *  typedef type_map<
+   *    type_pair<int_val<10>, get_handler>,
+   *    type_pair<int_val<30>, put_handler>,
+   *    type_pair<int_val<50>, get_handler>
+   *  > map;
+   *
+   *  // yields `true`
+   *  map::mapped_lookup<>::sorted_array()
+   *
+   *  // yields `false`
+   *  map::mapped_lookup<>::exact(20, visitor());
+   *
+   *  // yields `true` and calls `get_handler::handle(50)`
+   *  map::mapped_lookup<>::exact(50, visitor());
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename TComparer = type_value_comparer>
+  class mapped_lookup {
+    typedef typename detail::type_list_impl::make_index_pack<
+      sizeof...(Args)
+    >::type indexes;
+
+    typedef typename type_map::mapped::template unique<> mapped_set;
+
+    template <bool SortedArray>
+    using impl = detail::type_map_impl::mapped_lookup_impl<
+      SortedArray, TComparer, mapped_set, indexes, Args...
+    >;
+
+  public:
+    /**
+     * Tells whether `exact()` searches a static sorted array for integral
+     * needles, as opposed to performing a `binary_search`.
+     *
+     * @author: Marcelo Juchem <marcelo@fb.com>
+     */
+    static constexpr bool sorted_array() {
+      return detail::type_map_impl::mapped_lookup_select<
+        TComparer, indexes, Args...
+      >::value;
+    }
+
+    /**
+     * Refer to the `mapped_lookup` documentation above for more details.
+     *
+     * @author: Marcelo Juchem <marcelo@fb.com>
+     */
+    template <typename TNeedle, typename TVisitor, typename... VArgs>
+    static bool exact(TNeedle &&needle, TVisitor &&visitor, VArgs &&...args) {
+      return impl<
+        std::is_integral<typename std::decay<TNeedle>::type>::value
+          && sorted_array()
+      >::exact(
+        std::forward<TNeedle>(needle),
+        std::forward<TVisitor>(visitor),
+        std::forward<VArgs>(args)...
+      );
+    }
+  };
 };
 
 ///////////////////////////////
@@ -1073,6 +1416,246 @@ using clustered_index = typename detail::clustered_index_impl<
   TTransform, TTransforms...
 >::template type<TList>;
 
+////////////////////////
+// clustered_dispatch //
+////////////////////////
+
+namespace detail {
+namespace clustered_dispatch_impl {
+
+// flattens one index per level into a row-major index, yielding `End` when any
+// of them is out of range
+template <typename... TKeys> struct flat_index;
+
+template <typename TKeys, typename... TNested>
+struct flat_index<TKeys, TNested...> {
+  typedef flat_index<TNested...> nested;
+
+  static constexpr std::size_t size = TKeys::size * nested::size;
+
+  template <typename... UIndexes>
+  static constexpr std::size_t get(
+    std::size_t end, std::size_t flat, std::size_t index, UIndexes... indexes
+  ) {
+    return index < TKeys::size
+      ? nested::get(end, flat * TKeys::size + index, indexes...)
+      : end;
+  }
+};
+
+template <>
+struct flat_index<> {
+  static constexpr std::size_t size = 1;
+
+  static constexpr std::size_t get(std::size_t, std::size_t flat) {
+    return flat;
+  }
+};
+
+struct not_found {};
+
+// the keys and the mapped type found by descending into the nested maps of
+// `TMap` using the keys at the position represented by the row-major `Index`
+template <typename TMap, std::size_t Index, typename... TKeys>
+struct entry {
+  typedef type_list<> keys;
+  typedef TMap mapped;
+};
+
+template <typename TMap, std::size_t Index, typename TKeys, typename... TNested>
+struct entry<TMap, Index, TKeys, TNested...> {
+  typedef typename TKeys::template at<
+    Index / flat_index<TNested...>::size
+  > key;
+
+  typedef entry<
+    typename TMap::template find<key, not_found>,
+    Index % flat_index<TNested...>::size,
+    TNested...
+  > nested;
+
+  typedef typename nested::keys::template push_front<key> keys;
+  typedef typename nested::mapped mapped;
+};
+
+template <std::size_t Index, typename TKeys, typename... TNested>
+struct entry<not_found, Index, TKeys, TNested...> {
+  typedef type_list<> keys;
+  typedef not_found mapped;
+};
+
+template <typename TKeys, typename TMapped, std::size_t Index>
+struct call {
+  template <typename V, typename... VArgs>
+  static bool visit(V &&visitor, VArgs &&...args) {
+    visitor(
+      indexed_type_tag<type_pair<TKeys, TMapped>, Index>(),
+      std::forward<VArgs>(args)...
+    );
+
+    return true;
+  }
+};
+
+template <typename TKeys, std::size_t Index>
+struct call<TKeys, not_found, Index> {
+  template <typename V, typename... VArgs>
+  static bool visit(V &&, VArgs &&...) { return false; }
+};
+
+template <typename, typename, typename, typename, typename...> struct table;
+
+template <
+  std::size_t... Indexes, typename TMap, typename... TKeys,
+  typename V, typename... VArgs
+>
+struct table<
+  type_list_impl::index_pack<Indexes...>, TMap, type_list<TKeys...>,
+  V, VArgs...
+> {
+  typedef bool (*type)(V &&, VArgs &&...);
+
+  static constexpr type data[sizeof...(Indexes)] = {
+    &call<
+      typename entry<TMap, Indexes, TKeys...>::keys,
+      typename entry<TMap, Indexes, TKeys...>::mapped,
+      Indexes
+    >::template visit<V, VArgs...>...
+  };
+};
+
+template <
+  std::size_t... Indexes, typename TMap, typename... TKeys,
+  typename V, typename... VArgs
+>
+constexpr typename table<
+  type_list_impl::index_pack<Indexes...>, TMap, type_list<TKeys...>,
+  V, VArgs...
+>::type table<
+  type_list_impl::index_pack<Indexes...>, TMap, type_list<TKeys...>,
+  V, VArgs...
+>::data[sizeof...(Indexes)];
+
+} // namespace clustered_dispatch_impl {
+} // namespace detail {
+
+/**
+ * Flattens a nested map, like the ones built by `clustered_index`, into a
+ * single dispatch table, so that visiting an element given one runtime index
+ * per level costs a single indexed call, rather than a nested search per
+ * level.
+ *
+ * Each of `TKeys` is a `type_list` of the keys for the respective level of
+ * `TMap`. The runtime index for a level is the position of the key in its
+ * respective list, like the tag of a `variant` over its `types` or the index
+ * returned by `type_prefix_tree`'s `match<>::index` over its `sequences`.
+ *
+ * The table has an entry for every combination of keys, including those not
+ * present in `TMap`, so its size is the product of the sizes of `TKeys`.
+ *
+ * The visitor is called with an `indexed_type_tag` of a `type_pair` whose
+ * first type is a `type_list` with the key for each level and whose second
+ * type is the element found. `Index` is the row-major index of the element.
+ *
+ * Example:
+ *
+ *  struct foo { using type = int; using key_type = chr_val<'f'>; };
+ *  struct bar { using type = int; using key_type = chr_val<'b'>; };
+ *  struct baz { using type = long; using key_type = chr_val<'b'>; };
+ *
+ *  // int -> f -> foo, int -> b -> bar, long -> b -> baz
+ *  typedef clustered_index<
+ *    type_list<foo, bar, baz>,
+ *    get_member_typedef::type,
+ *    get_member_typedef::key_type
+ *  > index;
+ *
+ *  typedef clustered_dispatch<
+ *    index,
+ *    type_list<int, long>,
+ *    type_list<chr_val<'b'>, chr_val<'f'>>
+ *  > dispatch;
+ *
+ *  struct visitor {
+ *    template <typename TType, typename TKey, typename T, std::size_t Index>
+ *    void operator ()(
+ *      indexed_type_tag<type_pair<type_list<TType, TKey>, T>, Index>
+ *    ) {
+ *      std::cout << TKey::value << " at index " << Index << std::endl;
+ *    }
+ *  };
+ *
+ *  // yields `3`
+ *  dispatch::index(1, 1)
+ *
+ *  // yields `true` and prints `"b at index 2"`
+ *  dispatch::visit(dispatch::index(1, 0), visitor());
+ *
+ *  // yields `false` since there's no entry for `long -> f`
+ *  dispatch::visit(dispatch::index(1, 1), visitor());
+ *
+ *  // yields `false` since the index is out of range
+ *  dispatch::visit(dispatch::index(2, 0), visitor());
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <typename TMap, typename... TKeys>
+struct clustered_dispatch {
+  static_assert(sizeof...(TKeys) > 0, "at least one level of keys is needed");
+
+  /**
+   * The amount of entries in the dispatch table.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  static constexpr std::size_t size = detail::clustered_dispatch_impl
+    ::flat_index<TKeys...>::size;
+
+  /**
+   * Flattens the runtime indexes, one per level, into the index of the
+   * dispatch table entry. Yields `size` when any of them is out of range.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename... UIndexes>
+  static constexpr std::size_t index(UIndexes... indexes) {
+    static_assert(
+      sizeof...(UIndexes) == sizeof...(TKeys),
+      "expected exactly one index per level"
+    );
+
+    return detail::clustered_dispatch_impl::flat_index<TKeys...>::get(
+      size, 0, static_cast<std::size_t>(indexes)...
+    );
+  }
+
+  /**
+   * Calls the visitor for the entry at the given index of the dispatch table,
+   * as returned by `index()`, along with the additional arguments `args`.
+   *
+   * Returns `true` when the entry exists, `false` otherwise, in which case the
+   * visitor is not called.
+   *
+   * Refer to the `clustered_dispatch` documentation above for more details.
+   *
+   * Note: this is a runtime facility.
+   *
+   * @author: Marcelo Juchem <marcelo@fb.com>
+   */
+  template <typename TVisitor, typename... VArgs>
+  static bool visit(std::size_t index, TVisitor &&visitor, VArgs &&...args) {
+    return index < size && detail::clustered_dispatch_impl::table<
+      typename detail::type_list_impl::make_index_pack<size>::type,
+      TMap, type_list<TKeys...>, TVisitor, VArgs...
+    >::data[index](
+      std::forward<TVisitor>(visitor), std::forward<VArgs>(args)...
+    );
+  }
+};
+
+template <typename TMap, typename... TKeys>
+constexpr std::size_t clustered_dispatch<TMap, TKeys...>::size;
+
 ////////////////////////////
 // IMPLEMENTATION DETAILS //
 ////////////////////////////
@@ -0,0 +1,254 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#pragma once
+
+#include <fatal/type/list.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace fatal {
+namespace detail {
+namespace parallel_foreach_impl {
+
+// tells whether `T` has a member function `add()` accepting a task
+struct is_executor_impl {
+  template <typename> struct dummy {};
+
+  template <typename T>
+  static std::true_type sfinae(
+    dummy<decltype(std::declval<T &>().add(std::function<void()>()))> *
+  );
+
+  template <typename>
+  static std::false_type sfinae(...);
+};
+
+template <typename T>
+using is_executor = decltype(
+  is_executor_impl::sfinae<typename std::decay<T>::type>(nullptr)
+);
+
+// the state shared by all the workers of a single `parallel_foreach` call
+//
+// rather than having one task per type, each worker keeps claiming the next
+// type to be visited until there's none left, so that workers that finish
+// early pick up the remaining work instead of sitting idle
+template <typename TList, typename TRun>
+class scheduler {
+public:
+  scheduler(TRun &run, std::size_t workers):
+    run_(run),
+    pending_(workers)
+  {}
+
+  scheduler(scheduler const &) = delete;
+  scheduler &operator =(scheduler const &) = delete;
+
+  // runs on each worker
+  void work() {
+    drain();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!--pending_) {
+      done_.notify_one();
+    }
+  }
+
+  // runs on the calling thread, which also takes part in the work
+  void join() {
+    drain();
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [this]() { return pending_ == 0; });
+    }
+
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+private:
+  void drain() {
+    for (;;) {
+      auto const index = next_.fetch_add(1, std::memory_order_relaxed);
+
+      if (index >= TList::size) {
+        return;
+      }
+
+      try {
+        run_(index);
+      } catch (...) {
+        // stops handing out work and keeps the first exception around so it
+        // can be rethrown on the calling thread
+        next_.store(TList::size, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) {
+          error_ = std::current_exception();
+        }
+      }
+    }
+  }
+
+  TRun &run_;
+  std::atomic<std::size_t> next_{0};
+  std::mutex mutex_;
+  std::condition_variable done_;
+  std::size_t pending_;
+  std::exception_ptr error_;
+};
+
+} // namespace parallel_foreach_impl {
+} // namespace detail {
+
+/**
+ * Calls the given visitor for each type in the list `TList`, just like
+ * `type_list::foreach`, except that the calls are spread among the threads
+ * of the given executor and run concurrently. Returns only once all the
+ * calls are done.
+ *
+ * This is meant for visitors that do some real work for each type, like
+ * initializing a registry per type at startup. For trivial visitors the cost
+ * of synchronizing the threads outweighs any gains.
+ *
+ * The executor must provide a member function `add()` that accepts a
+ * `std::function<void()>` (like `folly::Executor`). A few tasks are added to
+ * the executor and the calling thread takes part in the work, so it is fine
+ * for the executor to be busy: the remaining calls are picked up by whichever
+ * thread is free. Still, this function waits until all the tasks added to the
+ * executor have run.
+ *
+ * The first parameter given to the visitor is `indexed_type_tag` with the
+ * list's type and its index, followed by `args`. Since the visitor and
+ * `args` are shared among all threads, they are passed as lvalue references
+ * and must be safe to use concurrently. The order of the calls is undefined.
+ *
+ * If the visitor throws, no more calls are started and, once the ones in
+ * flight are done, the first exception is rethrown on the calling thread.
+ *
+ * This function returns `true` if the list is not empty (visitor has been
+ * called for all types in the list) or `false` if the list is empty
+ * (visitor hasn't been called).
+ *
+ * Note: this is a runtime facility.
+ *
+ * Example:
+ *
+ *  struct visitor {
+ *    template <typename T, std::size_t Index>
+ *    void operator ()(indexed_type_tag<T, Index>, registry &r) {
+ *      r.load<T>();
+ *    }
+ *  };
+ *
+ *  typedef type_list<users, groups, permissions> list;
+ *
+ *  folly::CPUThreadPoolExecutor executor(8);
+ *  registry r;
+ *
+ *  // loads each type on its own thread
+ *  parallel_foreach<list>(executor, visitor(), r);
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <
+  typename TList, typename TExecutor, typename V, typename... VArgs,
+  typename = typename std::enable_if<
+    detail::parallel_foreach_impl::is_executor<TExecutor>::value
+  >::type
+>
+bool parallel_foreach(TExecutor &executor, V &&visitor, VArgs &&...args) {
+  auto run = [&](std::size_t index) { TList::visit(index, visitor, args...); };
+  typedef detail::parallel_foreach_impl::scheduler<TList, decltype(run)>
+    scheduler;
+
+  auto const workers = TList::empty ? 0 : TList::size - 1;
+  scheduler s(run, workers);
+
+  for (auto i = workers; i--; ) {
+    try {
+      executor.add(std::bind(&scheduler::work, std::addressof(s)));
+    } catch (...) {
+      // the calling thread takes over the worker that couldn't be added
+      s.work();
+    }
+  }
+
+  s.join();
+
+  return !TList::empty;
+}
+
+/**
+ * Same as the overload above, except that the calls are spread among new
+ * threads spawned for this purpose, one per hardware thread at most, which
+ * are joined before returning.
+ *
+ * Example:
+ *
+ *  // loads each type on its own thread
+ *  parallel_foreach<list>(visitor(), r);
+ *
+ * @author: Marcelo Juchem <marcelo@fb.com>
+ */
+template <
+  typename TList, typename V, typename... VArgs,
+  typename = typename std::enable_if<
+    !detail::parallel_foreach_impl::is_executor<V>::value
+  >::type
+>
+bool parallel_foreach(V &&visitor, VArgs &&...args) {
+  auto run = [&](std::size_t index) { TList::visit(index, visitor, args...); };
+  typedef detail::parallel_foreach_impl::scheduler<TList, decltype(run)>
+    scheduler;
+
+  // the calling thread takes part in the work too
+  auto const hardware = std::thread::hardware_concurrency();
+  auto const workers = TList::empty ? 0 : std::min<std::size_t>(
+    TList::size, hardware ? hardware : 1
+  ) - 1;
+
+  scheduler s(run, workers);
+
+  std::vector<std::thread> threads;
+  threads.reserve(workers);
+
+  for (auto i = workers; i--; ) {
+    try {
+      threads.emplace_back(&scheduler::work, std::addressof(s));
+    } catch (...) {
+      // the calling thread takes over the worker that couldn't be spawned
+      s.work();
+    }
+  }
+
+  s.join();
+
+  for (auto &thread: threads) {
+    thread.join();
+  }
+
+  return !TList::empty;
+}
+
+} // namespace fatal {
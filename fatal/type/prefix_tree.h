@@ -26,6 +26,30 @@ namespace fatal {
 
 struct non_terminal_tag {};
 
+namespace detail {
+namespace type_prefix_tree_impl {
+
+///////////////
+// sequences //
+///////////////
+
+// concatenates the sequences of each child, there are only as many of them as
+// there are distinct sequence elements at a given level
+template <typename...> struct sequences;
+
+template <typename... Args>
+struct sequences<type_list<Args...>> {
+  typedef type_list<Args...> type;
+};
+
+template <typename... Args, typename... UArgs, typename... TLists>
+struct sequences<type_list<Args...>, type_list<UArgs...>, TLists...>:
+  public sequences<type_list<Args..., UArgs...>, TLists...>
+{};
+
+} // namespace type_prefix_tree_impl {
+} // namespace detail {
+
 /**
  * Type prefix tree for template metaprogramming and efficient
  * switch/case implementation of strings and other sequences known
@@ -93,6 +117,38 @@ struct type_prefix_tree {
    */
   typedef type_map<TNodes...> map;
 
+  /**
+   * Derives from a `type_list` of all the sequences stored in this prefix
+   * tree, that is, the ones ending at a terminal node. This node's own
+   * sequence comes first (when it's a terminal node), followed by the
+   * sequences in each child subtree, in the same order as `map`.
+   *
+   * The `type_list` itself is available as `sequences::list`. This is a class
+   * rather than a typedef so that it's only computed when used, instead of
+   * for every node instantiated while building the prefix tree.
+   *
+   * The position of a sequence in this list is a dense index, in the range
+   * `[0, sequences::size)`, which is what `match::index` returns. It can be
+   * used to keep values associated with each sequence in a plain array.
+   *
+   * For a prefix tree built with `type_prefix_tree_builder` out of the words
+   * "fit", "hit" and "hint", `sequences::list` is equivalent to:
+   *
+   *  type_list<str<'f', 'i', 't'>, str<'h', 'i', 'n', 't'>, str<'h', 'i', 't'>>
+   */
+  struct sequences:
+    public detail::type_prefix_tree_impl::sequences<
+      typename std::conditional<
+        is_terminal::value,
+        type_list<sequence>,
+        type_list<>
+      >::type,
+      typename TNodes::second::sequences::list...
+    >::type
+  {
+    typedef typename sequences::type_list list;
+  };
+
   /**
    * `match` contains methods for looking up sequences in the prefix-tree
    * for matches.
@@ -293,6 +349,49 @@ struct type_prefix_tree {
       TVisitor &&visitor,
       VArgs &&...args
     );
+
+    /**
+     * Matches the range defined by `[begin, end)` againts this prefix
+     * tree, looking for an exact match, like `exact`.
+     *
+     * Returns the position of the matching sequence in `sequences` if a match
+     * is found, or `sequences::size` otherwise.
+     *
+     * This allows runtime values to be associated with each sequence by
+     * keeping them in an array indexed by the result.
+     *
+     * Note: this is a runtime facility.
+     *
+     * Example:
+     *
+     *  template <char c> using chr = std::integral_constant<char, c>;
+     *  template <char... s> using str = type_list<chr<s>...>;
+     *
+     *  typedef type_prefix_tree_builder<>::build<
+     *    str<'h', 'i', 't'>,
+     *    str<'h', 'o', 't'>,
+     *    str<'h', 'u', 't'>
+     *  > prefix_tree;
+     *
+     *  std::array<std::size_t, prefix_tree::sequences::size> counters{};
+     *
+     *  void count(std::string const &s) {
+     *    auto const i = prefix_tree::match<>::index(s.begin(), s.end());
+     *
+     *    if (i != prefix_tree::sequences::size) {
+     *      ++counters[i];
+     *    }
+     *  }
+     *
+     *  // increments the counter at
+     *  // `prefix_tree::sequences::index_of<str<'h', 'o', 't'>>::value`
+     *  count("hot");
+     *
+     *  // does nothing
+     *  count("hat");
+     */
+    template <typename TIterator>
+    static std::size_t index(TIterator begin, TIterator end);
   };
 };
 
@@ -514,6 +613,14 @@ struct match_visitor<non_terminal_tag> {
   }
 };
 
+template <typename TSequences>
+struct match_index {
+  template <typename TSequence>
+  void operator ()(type_tag<TSequence>, std::size_t &index) {
+    index = TSequences::template index_of<TSequence>::value;
+  }
+};
+
 template <typename TComparer>
 struct match_exact {
   template <
@@ -630,4 +737,27 @@ std::size_t type_prefix_tree<TSequence, TNodes...>::match<TComparer>::prefixes(
   return found;
 }
 
+template <typename TSequence, typename... TNodes>
+template <typename TComparer>
+template <typename TIterator>
+std::size_t type_prefix_tree<TSequence, TNodes...>::match<TComparer>::index(
+  TIterator begin,
+  TIterator end
+) {
+  // this node's own sequence, when terminal, is the first one in `sequences`
+  if (begin == end) {
+    return is_terminal::value ? 0 : sequences::size;
+  }
+
+  std::size_t index = sequences::size;
+
+  exact(
+    begin, end,
+    detail::type_prefix_tree_impl::match_index<sequences>{},
+    index
+  );
+
+  return index;
+}
+
 } // namespace fatal {
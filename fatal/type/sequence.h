@@ -16,6 +16,19 @@
 
 namespace fatal {
 
+////////////////////////////////////////
+// IMPLEMENTATION DETAILS DECLARATION //
+////////////////////////////////////////
+
+namespace detail {
+namespace constant_sequence_impl {
+
+template <typename T, T...> struct range_builder;
+template <typename T, T...> struct bucketize;
+
+} // namespace constant_sequence_impl {
+} // namespace detail {
+
 /**
  * A compile-time sequence of values for template metaprogramming.
  *
@@ -154,19 +167,72 @@ struct constant_sequence {
 
   template <type Terminator = 0>
   static constexpr z_array_type z_array() { return {{Values..., Terminator}}; }
-};
-
-////////////////////////////////////////
-// IMPLEMENTATION DETAILS DECLARATION //
-////////////////////////////////////////
-
-namespace detail {
-namespace constant_sequence_impl {
 
-template <typename T, T...> struct range_builder;
+  /**
+   * Tells which bucket the given value falls into, given that the values in
+   * this sequence are the sorted boundaries between consecutive buckets.
+   *
+   * Bucket `i` holds the values `v` where `boundary[i - 1] <= v` and
+   * `v < boundary[i]`. Therefore, the result is in the range `[0, size]`.
+   *
+   * The search is branchless. Short sequences are scanned linearly while
+   * longer ones are binary searched.
+   *
+   * Note: this is a runtime facility.
+   *
+   * Example:
+   *
+   *  typedef constant_sequence<int, 10, 20, 30> seq;
+   *
+   *  // yields `0`
+   *  auto result1 = seq::bucket(5);
+   *
+   *  // yields `2`
+   *  auto result2 = seq::bucket(20);
+   *
+   *  // yields `3`
+   *  auto result3 = seq::bucket(99);
+   */
+  static std::size_t bucket(type value) {
+    return detail::constant_sequence_impl::bucketize<type, Values...>::bucket(
+      value
+    );
+  }
 
-} // namespace constant_sequence_impl {
-} // namespace detail {
+  /**
+   * Writes, for each value in the range `[begin, end)`, the bucket it falls
+   * into to `out`, in the same order. See `bucket()` for details.
+   *
+   * Returns the output iterator past the last element written, like
+   * `std::transform`.
+   *
+   * There are no dependencies between elements, so the compiler is free to
+   * classify several values at once with vector instructions when the
+   * sequence is short enough to be scanned linearly.
+   *
+   * Note: this is a runtime facility.
+   *
+   * Example:
+   *
+   *  typedef constant_sequence<int, 10, 20, 30> seq;
+   *
+   *  std::array<int, 4> values{{5, 20, 29, 99}};
+   *  std::array<std::size_t, 4> buckets;
+   *
+   *  // `buckets` will contain `{0, 2, 2, 3}`
+   *  seq::bucketize(values.begin(), values.end(), buckets.begin());
+   */
+  template <typename TInputIterator, typename TOutputIterator>
+  static TOutputIterator bucketize(
+    TInputIterator begin, TInputIterator end, TOutputIterator out
+  ) {
+    for (; begin != end; ++begin, ++out) {
+      *out = bucket(*begin);
+    }
+
+    return out;
+  }
+};
 
 /////////////////////
 // SUPPORT LIBRARY //
@@ -227,6 +293,58 @@ struct range_builder<T, Begin, End> {
   >::type type;
 };
 
+///////////////
+// bucketize //
+///////////////
+
+template <typename T, T... Values>
+struct bucketize {
+  static_assert(
+    constant_sequence<T, Values...>::list::template is_sorted<>::value,
+    "the bucket boundaries must be sorted"
+  );
+
+  static constexpr std::size_t size = sizeof...(Values);
+
+  // sequences up to this size are scanned linearly
+  static constexpr std::size_t linear_threshold = 32;
+
+  // padded so that it is never empty
+  static constexpr T data[size + 1] = { Values..., T() };
+
+  // counts the boundaries not greater than `value`
+  static std::size_t linear(T value) {
+    std::size_t result = 0;
+
+    for (std::size_t i = 0; i < size; ++i) {
+      result += !(value < data[i]);
+    }
+
+    return result;
+  }
+
+  // the index of the first boundary greater than `value`, as in
+  // `std::upper_bound`, halving the range with conditional moves
+  static std::size_t binary(T value) {
+    T const *base = data;
+
+    for (std::size_t n = size; n > 1; ) {
+      auto const half = n / 2;
+      base = value < base[half] ? base : base + half;
+      n -= half;
+    }
+
+    return static_cast<std::size_t>(base - data) + (size && !(value < *base));
+  }
+
+  static std::size_t bucket(T value) {
+    return size <= linear_threshold ? linear(value) : binary(value);
+  }
+};
+
+template <typename T, T... Values>
+constexpr T bucketize<T, Values...>::data[size + 1];
+
 } // namespace constant_sequence_impl {
 } // namespace detail {
 } // namespace fatal {
@@ -13,6 +13,12 @@
 
 #include <folly/Preprocessor.h>
 
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+#include <cstdint>
 #include <cstring>
 
 namespace fatal {
@@ -25,6 +31,141 @@ namespace fatal {
 FATAL_RICH_ENUM(test_enum, str_class, ENUMIFY_TEST_ENUM);
 #undef ENUMIFY_TEST_ENUM
 
+#define ENUMIFY_DENSE_ENUM(FIRST, MID, LAST, ...) \
+  FIRST(a, -2, __VA_ARGS__) \
+  MID(bb, __VA_ARGS__) \
+  MID(ccc, __VA_ARGS__) \
+  LAST(dddd, __VA_ARGS__)
+FATAL_RICH_ENUM(dense_enum, dense_str_class, ENUMIFY_DENSE_ENUM);
+#undef ENUMIFY_DENSE_ENUM
+
+#define ENUMIFY_PERMISSION(FIRST, MID, LAST, ...) \
+  FIRST(read, 1, __VA_ARGS__) \
+  MID(write, 2, __VA_ARGS__) \
+  MID(exec, 4, __VA_ARGS__) \
+  LAST(sticky, 16, __VA_ARGS__)
+FATAL_RICH_ENUM(permission, permission_str, ENUMIFY_PERMISSION);
+#undef ENUMIFY_PERMISSION
+
+#define ENUMIFY_LARGE_ENUM(FIRST, MID, LAST, ...) \
+  FIRST(alpha, __VA_ARGS__) \
+  MID(alpha_min, 7, __VA_ARGS__) \
+  MID(alpha_max, 14, __VA_ARGS__) \
+  MID(beta, 21, __VA_ARGS__) \
+  MID(beta_min, 28, __VA_ARGS__) \
+  MID(beta_max, 35, __VA_ARGS__) \
+  MID(gamma, 42, __VA_ARGS__) \
+  MID(gamma_min, 49, __VA_ARGS__) \
+  MID(gamma_max, 56, __VA_ARGS__) \
+  MID(delta, 63, __VA_ARGS__) \
+  MID(delta_min, 70, __VA_ARGS__) \
+  MID(delta_max, 77, __VA_ARGS__) \
+  MID(epsilon, 84, __VA_ARGS__) \
+  MID(epsilon_min, 91, __VA_ARGS__) \
+  MID(epsilon_max, 98, __VA_ARGS__) \
+  MID(zeta, 105, __VA_ARGS__) \
+  MID(zeta_min, 112, __VA_ARGS__) \
+  MID(zeta_max, 119, __VA_ARGS__) \
+  MID(eta, 126, __VA_ARGS__) \
+  MID(eta_min, 133, __VA_ARGS__) \
+  MID(eta_max, 140, __VA_ARGS__) \
+  MID(theta, 147, __VA_ARGS__) \
+  MID(theta_min, 154, __VA_ARGS__) \
+  LAST(theta_max, __VA_ARGS__)
+FATAL_RICH_ENUM(large_enum, large_str_class, ENUMIFY_LARGE_ENUM);
+#undef ENUMIFY_LARGE_ENUM
+
+#define ENUMIFY_HUGE_ENUM(FIRST, MID, LAST, ...) \
+  FIRST(f0, __VA_ARGS__) \
+  MID(f1, __VA_ARGS__) \
+  MID(f2, __VA_ARGS__) \
+  MID(f3, __VA_ARGS__) \
+  MID(f4, __VA_ARGS__) \
+  MID(f5, __VA_ARGS__) \
+  MID(f6, __VA_ARGS__) \
+  MID(f7, __VA_ARGS__) \
+  MID(f8, __VA_ARGS__) \
+  MID(f9, __VA_ARGS__) \
+  MID(f10, __VA_ARGS__) \
+  MID(f11, __VA_ARGS__) \
+  MID(f12, __VA_ARGS__) \
+  MID(f13, __VA_ARGS__) \
+  MID(f14, __VA_ARGS__) \
+  MID(f15, __VA_ARGS__) \
+  MID(f16, __VA_ARGS__) \
+  MID(f17, __VA_ARGS__) \
+  MID(f18, __VA_ARGS__) \
+  MID(f19, __VA_ARGS__) \
+  MID(f20, __VA_ARGS__) \
+  MID(f21, __VA_ARGS__) \
+  MID(f22, __VA_ARGS__) \
+  MID(f23, __VA_ARGS__) \
+  MID(f24, __VA_ARGS__) \
+  MID(f25, __VA_ARGS__) \
+  MID(f26, __VA_ARGS__) \
+  MID(f27, __VA_ARGS__) \
+  MID(f28, __VA_ARGS__) \
+  MID(f29, __VA_ARGS__) \
+  MID(f30, __VA_ARGS__) \
+  MID(f31, __VA_ARGS__) \
+  MID(f32, __VA_ARGS__) \
+  MID(f33, __VA_ARGS__) \
+  MID(f34, __VA_ARGS__) \
+  MID(f35, __VA_ARGS__) \
+  MID(f36, __VA_ARGS__) \
+  MID(f37, __VA_ARGS__) \
+  MID(f38, __VA_ARGS__) \
+  MID(f39, __VA_ARGS__) \
+  MID(f40, __VA_ARGS__) \
+  MID(f41, __VA_ARGS__) \
+  MID(f42, __VA_ARGS__) \
+  MID(f43, __VA_ARGS__) \
+  MID(f44, __VA_ARGS__) \
+  MID(f45, __VA_ARGS__) \
+  MID(f46, __VA_ARGS__) \
+  MID(f47, __VA_ARGS__) \
+  MID(f48, __VA_ARGS__) \
+  MID(f49, __VA_ARGS__) \
+  MID(f50, __VA_ARGS__) \
+  MID(f51, __VA_ARGS__) \
+  MID(f52, __VA_ARGS__) \
+  MID(f53, __VA_ARGS__) \
+  MID(f54, __VA_ARGS__) \
+  MID(f55, __VA_ARGS__) \
+  MID(f56, __VA_ARGS__) \
+  MID(f57, __VA_ARGS__) \
+  MID(f58, __VA_ARGS__) \
+  MID(f59, __VA_ARGS__) \
+  MID(f60, __VA_ARGS__) \
+  MID(f61, __VA_ARGS__) \
+  MID(f62, __VA_ARGS__) \
+  MID(f63, __VA_ARGS__) \
+  MID(f64, __VA_ARGS__) \
+  MID(f65, __VA_ARGS__) \
+  MID(f66, __VA_ARGS__) \
+  MID(f67, __VA_ARGS__) \
+  MID(f68, __VA_ARGS__) \
+  LAST(f69, __VA_ARGS__)
+FATAL_RICH_ENUM(huge_enum, huge_str_class, ENUMIFY_HUGE_ENUM);
+#undef ENUMIFY_HUGE_ENUM
+
+#define ENUMIFY_SIGNED_ENUM(FIRST, MID, LAST, ...) \
+  FIRST(minus_seven, -7, __VA_ARGS__) \
+  MID(nine, 9, __VA_ARGS__) \
+  MID(zero, 0, __VA_ARGS__) \
+  LAST(minus_forty, -40, __VA_ARGS__)
+FATAL_RICH_ENUM(signed_enum, signed_str_class, ENUMIFY_SIGNED_ENUM);
+#undef ENUMIFY_SIGNED_ENUM
+
+#define ENUMIFY_SPARSE_ENUM(FIRST, MID, LAST, ...) \
+  FIRST(far_below, -1000000, __VA_ARGS__) \
+  MID(near, 3, __VA_ARGS__) \
+  MID(far_above, 1048576, __VA_ARGS__) \
+  MID(below, -3, __VA_ARGS__) \
+  LAST(above, 70000, __VA_ARGS__)
+FATAL_RICH_ENUM(sparse_enum, sparse_str_class, ENUMIFY_SPARSE_ENUM);
+#undef ENUMIFY_SPARSE_ENUM
+
 ///////////
 // enums //
 ///////////
@@ -38,10 +179,163 @@ TEST(enums, declare_enum) {
 
 TEST(enums, to_str) {
   EXPECT_EQ(nullptr, str_class::to_str(static_cast<test_enum>(-1)));
-  EXPECT_EQ(FB_STRINGIZE(state0), str_class::to_str(test_enum::state0));
-  EXPECT_EQ(FB_STRINGIZE(state1), str_class::to_str(test_enum::state1));
-  EXPECT_EQ(FB_STRINGIZE(state2), str_class::to_str(test_enum::state2));
-  EXPECT_EQ(FB_STRINGIZE(state3), str_class::to_str(test_enum::state3));
+  EXPECT_EQ(nullptr, str_class::to_str(static_cast<test_enum>(1)));
+  EXPECT_STREQ(FB_STRINGIZE(state0), str_class::to_str(test_enum::state0));
+  EXPECT_STREQ(FB_STRINGIZE(state1), str_class::to_str(test_enum::state1));
+  EXPECT_STREQ(FB_STRINGIZE(state2), str_class::to_str(test_enum::state2));
+  EXPECT_STREQ(FB_STRINGIZE(state3), str_class::to_str(test_enum::state3));
+
+  EXPECT_EQ(nullptr, dense_str_class::to_str(static_cast<dense_enum>(-3)));
+  EXPECT_EQ(nullptr, dense_str_class::to_str(static_cast<dense_enum>(2)));
+  EXPECT_STREQ(FB_STRINGIZE(a), dense_str_class::to_str(dense_enum::a));
+  EXPECT_STREQ(FB_STRINGIZE(bb), dense_str_class::to_str(dense_enum::bb));
+  EXPECT_STREQ(FB_STRINGIZE(ccc), dense_str_class::to_str(dense_enum::ccc));
+  EXPECT_STREQ(FB_STRINGIZE(dddd), dense_str_class::to_str(dense_enum::dddd));
+}
+
+TEST(enums, to_str_with_length) {
+# define CREATE_TEST(c, e, x) \
+  do { \
+    auto const s = c::to_str_with_length(e::x); \
+    EXPECT_EQ(std::string(FB_STRINGIZE(x)), std::string(s.first, s.second)); \
+    EXPECT_EQ(c::to_str(e::x), s.first); \
+    EXPECT_EQ('\0', s.first[s.second]); \
+  } while (false)
+  CREATE_TEST(str_class, test_enum, state0);
+  CREATE_TEST(str_class, test_enum, state1);
+  CREATE_TEST(str_class, test_enum, state2);
+  CREATE_TEST(str_class, test_enum, state3);
+  CREATE_TEST(dense_str_class, dense_enum, a);
+  CREATE_TEST(dense_str_class, dense_enum, bb);
+  CREATE_TEST(dense_str_class, dense_enum, ccc);
+  CREATE_TEST(dense_str_class, dense_enum, dddd);
+# undef CREATE_TEST
+
+  auto const invalid = str_class::to_str_with_length(
+    static_cast<test_enum>(-1)
+  );
+  EXPECT_EQ(nullptr, invalid.first);
+  EXPECT_EQ(0, invalid.second);
+
+  auto const dense_invalid = dense_str_class::to_str_with_length(
+    static_cast<dense_enum>(2)
+  );
+  EXPECT_EQ(nullptr, dense_invalid.first);
+  EXPECT_EQ(0, dense_invalid.second);
+}
+
+template <typename TStr, typename TUnderlying>
+void check_index_of(TUnderlying begin, TUnderlying end) {
+  typedef typename TStr::values values;
+  typedef typename values::type type;
+
+  auto const data = values::template typed_apply<
+    detail::enum_impl::value_table
+  >::data;
+
+  for (auto i = begin; i != end; ++i) {
+    auto const e = static_cast<type>(i);
+    auto const expected = static_cast<std::size_t>(
+      std::find(data, data + values::size, e) - data
+    );
+
+    EXPECT_EQ(expected, TStr::index_of(e));
+    EXPECT_EQ(expected != values::size, TStr::is_valid(i));
+  }
+
+  for (std::size_t i = 0; i < values::size; ++i) {
+    EXPECT_EQ(i, TStr::index_of(data[i]));
+    EXPECT_TRUE(TStr::is_valid(static_cast<TUnderlying>(data[i])));
+  }
+}
+
+TEST(enums, index_of) {
+  EXPECT_EQ(0, str_class::index_of(test_enum::state0));
+  EXPECT_EQ(1, str_class::index_of(test_enum::state1));
+  EXPECT_EQ(2, str_class::index_of(test_enum::state2));
+  EXPECT_EQ(3, str_class::index_of(test_enum::state3));
+  EXPECT_EQ(4, str_class::index_of(static_cast<test_enum>(5)));
+
+  EXPECT_EQ(0, signed_str_class::index_of(signed_enum::minus_seven));
+  EXPECT_EQ(1, signed_str_class::index_of(signed_enum::nine));
+  EXPECT_EQ(2, signed_str_class::index_of(signed_enum::zero));
+  EXPECT_EQ(3, signed_str_class::index_of(signed_enum::minus_forty));
+  EXPECT_EQ(4, signed_str_class::index_of(static_cast<signed_enum>(-41)));
+
+  check_index_of<str_class>(-300, 300);
+  check_index_of<dense_str_class>(-300, 300);
+  check_index_of<permission_str>(-300, 300);
+  check_index_of<large_str_class>(-300, 300);
+  check_index_of<signed_str_class>(-300, 300);
+  check_index_of<sparse_str_class>(-300, 300);
+  check_index_of<sparse_str_class>(-1000300, -999700);
+  check_index_of<sparse_str_class>(1048276, 1048876);
+}
+
+TEST(enums, is_valid) {
+  EXPECT_TRUE(str_class::is_valid(0));
+  EXPECT_TRUE(str_class::is_valid(97));
+  EXPECT_FALSE(str_class::is_valid(1));
+  EXPECT_FALSE(str_class::is_valid(-1));
+
+  EXPECT_TRUE(dense_str_class::is_valid(-2));
+  EXPECT_TRUE(dense_str_class::is_valid(1));
+  EXPECT_FALSE(dense_str_class::is_valid(-3));
+  EXPECT_FALSE(dense_str_class::is_valid(2));
+
+  EXPECT_TRUE(permission_str::is_valid(16));
+  EXPECT_FALSE(permission_str::is_valid(3));
+  EXPECT_FALSE(permission_str::is_valid(17));
+
+  EXPECT_TRUE(sparse_str_class::is_valid(-1000000));
+  EXPECT_TRUE(sparse_str_class::is_valid(1048576));
+  EXPECT_FALSE(sparse_str_class::is_valid(0));
+  EXPECT_FALSE(sparse_str_class::is_valid(1048577));
+}
+
+TEST(enums, string_table) {
+  typedef dense_str_class::string_table table;
+
+  EXPECT_EQ(4, table::size);
+
+  char const expected[] = "a\0bb\0ccc\0dddd";
+  EXPECT_EQ(sizeof(expected), sizeof(table::data));
+  EXPECT_EQ(0, std::memcmp(expected, table::data, sizeof(expected)));
+
+  EXPECT_EQ(table::data, table::c_str(0));
+  EXPECT_EQ(table::data + 2, table::c_str(1));
+  EXPECT_EQ(table::data + 5, table::c_str(2));
+  EXPECT_EQ(table::data + 9, table::c_str(3));
+
+  EXPECT_EQ(1, table::length(0));
+  EXPECT_EQ(2, table::length(1));
+  EXPECT_EQ(3, table::length(2));
+  EXPECT_EQ(4, table::length(3));
+}
+
+TEST(enums, perfect_hash) {
+  typedef large_str_class::string_table table;
+  typedef large_str_class::perfect_hash hash;
+
+  EXPECT_EQ(24, table::size);
+
+  for (std::size_t i = 0; i < table::size; ++i) {
+    std::string const s(table::c_str(i), table::length(i));
+    EXPECT_EQ(i, hash::find(s.begin(), s.end()));
+    EXPECT_EQ(table::size, hash::find(s.begin(), std::prev(s.end())));
+    EXPECT_EQ(table::size, hash::find(s.begin(), s.begin()));
+
+    auto const longer = s + "_";
+    EXPECT_EQ(table::size, hash::find(longer.begin(), longer.end()));
+
+    auto mismatch = s;
+    mismatch.back() = '#';
+    EXPECT_EQ(table::size, hash::find(mismatch.begin(), mismatch.end()));
+
+    large_enum out = large_enum::alpha;
+    EXPECT_TRUE(large_str_class::try_parse(out, s));
+    EXPECT_EQ(s, large_str_class::to_str(out));
+  }
 }
 
 TEST(enums, parse) {
@@ -139,4 +433,184 @@ TEST(enums, try_parse) {
   } while (false);
 }
 
+TEST(enums, parse_flags) {
+  typedef permission_str::flags flags;
+  typedef std::underlying_type<permission>::type underlying;
+
+  expect_same<
+    flag_set<
+      std::integral_constant<permission, permission::read>,
+      std::integral_constant<permission, permission::write>,
+      std::integral_constant<permission, permission::exec>,
+      std::integral_constant<permission, permission::sticky>
+    >,
+    flags
+  >();
+
+  EXPECT_EQ(
+    0b0101,
+    permission_str::parse_flags(std::string("read|exec")).get()
+  );
+  EXPECT_EQ(0b1000, permission_str::parse_flags(std::string("sticky")).get());
+  EXPECT_EQ(0, permission_str::parse_flags(std::string()).get());
+  EXPECT_EQ(
+    0b0011,
+    permission_str::parse_flags(std::string("write,read,write"), ',').get()
+  );
+
+  auto const all = permission_str::parse_flags(
+    std::string("sticky|exec|write|read")
+  );
+  EXPECT_TRUE((
+    all.is_set<
+      std::integral_constant<permission, permission::read>,
+      std::integral_constant<permission, permission::sticky>
+    >()
+  ));
+  EXPECT_EQ(0b1111, all.get());
+
+  for (auto const s: {
+    "read|", "|read", "read||exec", "read|exec ", "read,exec", "readexec", "|"
+  }) {
+    std::string const str(s);
+    EXPECT_THROW(permission_str::parse_flags(str), std::invalid_argument);
+
+    flags out = flags::from_integral(0b0010);
+    EXPECT_FALSE(permission_str::try_parse_flags(out, str));
+    EXPECT_EQ(0b0010, out.get());
+
+    underlying bits = 7;
+    EXPECT_FALSE(permission_str::try_parse_flags(bits, str));
+    EXPECT_EQ(7, bits);
+  }
+
+  std::string const s("exec|sticky|read");
+
+  flags out;
+  EXPECT_TRUE(permission_str::try_parse_flags(out, s.begin(), s.end()));
+  EXPECT_EQ(0b1101, out.get());
+
+  underlying bits = 0;
+  EXPECT_TRUE(permission_str::try_parse_flags(bits, s));
+  EXPECT_EQ(1 | 4 | 16, bits);
+
+  EXPECT_TRUE(permission_str::try_parse_flags(bits, std::string()));
+  EXPECT_EQ(0, bits);
+}
+
+TEST(enums, to_flags_str) {
+  typedef permission_str::flags flags;
+
+  std::string out;
+  permission_str::to_flags_str(out, flags::from_integral(0b1101));
+  EXPECT_EQ("read|exec|sticky", out);
+
+  out.clear();
+  permission_str::to_flags_str(out, flags());
+  EXPECT_EQ("", out);
+
+  out = "x=";
+  permission_str::to_flags_str(out, flags::from_integral(0b0110), ',');
+  EXPECT_EQ("x=write,exec", out);
+
+  out.clear();
+  EXPECT_TRUE(permission_str::to_flags_str(out, 1 | 2 | 16));
+  EXPECT_EQ("read|write|sticky", out);
+
+  out.clear();
+  EXPECT_FALSE(permission_str::to_flags_str(out, 4 | 8));
+  EXPECT_EQ("exec", out);
+
+  out.clear();
+  EXPECT_TRUE(permission_str::to_flags_str(out, 0));
+  EXPECT_EQ("", out);
+
+  out.clear();
+  permission_str::to_flags_str(
+    out, permission_str::parse_flags(std::string("sticky|write"))
+  );
+  EXPECT_EQ("write|sticky", out);
+}
+
+TEST(enums, huge_enum) {
+  typedef huge_str_class::flags flags;
+
+  EXPECT_EQ(70, huge_str_class::values::size);
+  expect_same<std::array<std::uint64_t, 2>, flags::flags_type>();
+
+  EXPECT_EQ("f65", std::string(huge_str_class::to_str(huge_enum::f65)));
+  EXPECT_EQ(huge_enum::f69, huge_str_class::parse(std::string("f69")));
+
+  auto const parsed = huge_str_class::parse_flags(std::string("f69|f0|f64"));
+  EXPECT_TRUE((
+    parsed.is_set<
+      std::integral_constant<huge_enum, huge_enum::f0>,
+      std::integral_constant<huge_enum, huge_enum::f64>,
+      std::integral_constant<huge_enum, huge_enum::f69>
+    >()
+  ));
+  EXPECT_EQ(3, parsed.count());
+
+  flags out;
+  EXPECT_FALSE(huge_str_class::try_parse_flags(out, std::string("f1|f70")));
+  EXPECT_FALSE(out.any());
+
+  std::string str;
+  huge_str_class::to_flags_str(str, parsed);
+  EXPECT_EQ("f0|f64|f69", str);
+}
+
+TEST(enums, parse_batch) {
+  std::vector<std::string> const input{
+    "state2", "state", "", "state0", "state3", "state1invalid", "state1",
+    "dddd", "state0"
+  };
+
+  std::vector<test_enum> out(input.size(), static_cast<test_enum>(-1));
+  std::vector<bool> valid(input.size(), true);
+
+  EXPECT_EQ(5, str_class::parse_batch(input, out.begin(), valid.begin()));
+
+  std::vector<bool> const expected_valid{
+    true, false, false, true, true, false, true, false, true
+  };
+  EXPECT_EQ(expected_valid, valid);
+
+  EXPECT_EQ(test_enum::state2, out[0]);
+  EXPECT_EQ(static_cast<test_enum>(-1), out[1]);
+  EXPECT_EQ(static_cast<test_enum>(-1), out[2]);
+  EXPECT_EQ(test_enum::state0, out[3]);
+  EXPECT_EQ(test_enum::state3, out[4]);
+  EXPECT_EQ(static_cast<test_enum>(-1), out[5]);
+  EXPECT_EQ(test_enum::state1, out[6]);
+  EXPECT_EQ(static_cast<test_enum>(-1), out[7]);
+  EXPECT_EQ(test_enum::state0, out[8]);
+
+  std::string const dense_input[] = { "ccc", "a", "e", "bb" };
+  dense_enum dense_out[] = {
+    dense_enum::dddd, dense_enum::dddd, dense_enum::dddd, dense_enum::dddd
+  };
+  bool dense_valid[] = { false, false, false, false };
+
+  EXPECT_EQ(
+    3,
+    dense_str_class::parse_batch(dense_input, dense_out, dense_valid)
+  );
+  EXPECT_EQ(dense_enum::ccc, dense_out[0]);
+  EXPECT_EQ(dense_enum::a, dense_out[1]);
+  EXPECT_EQ(dense_enum::dddd, dense_out[2]);
+  EXPECT_EQ(dense_enum::bb, dense_out[3]);
+  EXPECT_TRUE(dense_valid[0]);
+  EXPECT_TRUE(dense_valid[1]);
+  EXPECT_FALSE(dense_valid[2]);
+  EXPECT_TRUE(dense_valid[3]);
+
+  EXPECT_EQ(
+    0,
+    str_class::parse_batch(
+      std::vector<std::string>(), out.begin(), valid.begin()
+    )
+  );
+}
+
 } // namespace fatal {
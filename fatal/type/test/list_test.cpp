@@ -8,12 +8,17 @@
  */
 
 #include <fatal/type/list.h>
+#include <fatal/type/sequence.h>
 #include <fatal/type/traits.h>
 
 #include <fatal/test/driver.h>
 
 #include <folly/Conv.h>
 
+#include <array>
+
+#include <cstdint>
+
 namespace fatal {
 
 ///////////////
@@ -154,6 +159,59 @@ TEST(type_list, index_of) {
   EXPECT_EQ(8, tpls::index_of<S<2>>::value);
 }
 
+TEST(type_list, index_of_duplicates) {
+  typedef type_list<T<0>, T<1>, T<0>, T<2>, T<1>> dup;
+
+  EXPECT_EQ(0, dup::index_of<T<0>>::value);
+  EXPECT_EQ(1, dup::index_of<T<1>>::value);
+  EXPECT_EQ(3, dup::index_of<T<2>>::value);
+  EXPECT_EQ(dup::size, dup::index_of<T<3>>::value);
+
+  EXPECT_TRUE((std::is_same<T<0>, dup::at<2>>::value));
+  EXPECT_TRUE((std::is_same<T<1>, dup::at<4>>::value));
+}
+
+// a permutation of `long_list`
+template <typename T>
+using shuffle_transform = int_val<(T::value * 7) % 2400>;
+
+// long enough to exceed the default template instantiation depth limit if
+// any of these operations were linear recursive
+typedef constant_range<int, 0, 800>::list
+  ::transform<multiply_transform<int, 3>::type> long_list;
+
+TEST(type_list, long_list) {
+  EXPECT_EQ(800, long_list::size);
+
+  EXPECT_TRUE((std::is_same<int_val<0>, long_list::at<0>>::value));
+  EXPECT_TRUE((std::is_same<int_val<1200>, long_list::at<400>>::value));
+  EXPECT_TRUE((std::is_same<int_val<2397>, long_list::at<799>>::value));
+
+  EXPECT_TRUE((std::is_same<
+    type_list<int_val<2397>>, long_list::try_at<799>
+  >::value));
+  EXPECT_TRUE((std::is_same<type_list<>, long_list::try_at<800>>::value));
+
+  EXPECT_EQ(0, long_list::index_of<int_val<0>>::value);
+  EXPECT_EQ(400, long_list::index_of<int_val<1200>>::value);
+  EXPECT_EQ(799, long_list::index_of<int_val<2397>>::value);
+  EXPECT_EQ(800, long_list::index_of<int_val<1>>::value);
+
+  EXPECT_TRUE(long_list::contains<int_val<1200>>::value);
+  EXPECT_FALSE(long_list::contains<int_val<1201>>::value);
+
+  EXPECT_TRUE(long_list::is_sorted<>::value);
+  expect_same<long_list, long_list::concat<long_list>::unique<>>();
+  expect_same<
+    long_list,
+    long_list::transform<shuffle_transform>::merge_sort<>
+  >();
+  expect_same<
+    long_list::concat<long_list>::merge_sort<>,
+    long_list::merge<long_list>
+  >();
+}
+
 ////////////////////////
 // type_list::type_at //
 ////////////////////////
@@ -196,6 +254,69 @@ TEST(type_list, type_at) {
   EXPECT_EQ(typeid(S<2>), tpls::type_at(8));
 }
 
+TEST(type_list, type_at_out_of_bounds) {
+  EXPECT_EQ(typeid(P<2>), tp::type_at(3));
+  EXPECT_EQ(typeid(P<2>), tp::type_at(100));
+  EXPECT_EQ(typeid(T<0>), single::type_at(1));
+}
+
+//////////////////////////
+// type_list::sizeof_at //
+//////////////////////////
+
+TEST(type_list, sizeof_at) {
+  typedef type_list<char, std::int32_t, std::int64_t, std::array<char, 7>> l;
+
+  EXPECT_EQ(sizeof(char), l::sizeof_at(0));
+  EXPECT_EQ(sizeof(std::int32_t), l::sizeof_at(1));
+  EXPECT_EQ(sizeof(std::int64_t), l::sizeof_at(2));
+  EXPECT_EQ(7, l::sizeof_at(3));
+  EXPECT_EQ(7, l::sizeof_at(4));
+}
+
+///////////////////////////
+// type_list::alignof_at //
+///////////////////////////
+
+TEST(type_list, alignof_at) {
+  typedef type_list<char, std::int32_t, std::int64_t, std::array<char, 7>> l;
+
+  EXPECT_EQ(alignof(char), l::alignof_at(0));
+  EXPECT_EQ(alignof(std::int32_t), l::alignof_at(1));
+  EXPECT_EQ(alignof(std::int64_t), l::alignof_at(2));
+  EXPECT_EQ(1, l::alignof_at(3));
+  EXPECT_EQ(1, l::alignof_at(4));
+}
+
+/////////////////////////
+// type_list::as_array //
+/////////////////////////
+
+template <typename T>
+using size_of = std::integral_constant<std::size_t, sizeof(T)>;
+
+TEST(type_list, as_array) {
+  typedef type_list<std::int8_t, std::int32_t, std::int64_t, std::int16_t> l;
+
+  auto const &sizes = l::as_array<size_of>();
+  expect_same<std::array<std::size_t, 4> const &, decltype(sizes)>();
+  EXPECT_EQ((std::array<std::size_t, 4>{{1, 4, 8, 2}}), sizes);
+  EXPECT_EQ(&sizes, &l::as_array<size_of>());
+
+  auto const &ints = l::as_array<size_of, int>();
+  expect_same<std::array<int, 4> const &, decltype(ints)>();
+  EXPECT_EQ((std::array<int, 4>{{1, 4, 8, 2}}), ints);
+
+  static_assert(l::as_array<size_of>().size() == 4, "constexpr");
+
+  typedef type_list<int_val<-1>, std::integral_constant<long, 10>> mixed;
+  auto const &values = mixed::as_array<transform::identity>();
+  expect_same<std::array<long, 2> const &, decltype(values)>();
+  EXPECT_EQ((std::array<long, 2>{{-1, 10}}), values);
+
+  EXPECT_TRUE((type_list<>::as_array<size_of, int>().empty()));
+}
+
 /////////////////////////
 // type_list::contains //
 /////////////////////////
@@ -479,6 +600,59 @@ TEST(type_list, visit) {
   EXPECT_FALSE(list::visit(5, visit_no_visit_test_visitor(), 5));
 }
 
+struct visit_index_test_visitor {
+  template <int Value, std::size_t Index>
+  void operator ()(indexed_type_tag<T<Value>, Index>, std::size_t &out) {
+    EXPECT_EQ(Value, static_cast<int>(Index) * 2);
+    out = Index;
+  }
+};
+
+TEST(type_list, visit_large) {
+  using list = type_list<
+    T<0>, T<2>, T<4>, T<6>, T<8>, T<10>, T<12>, T<14>, T<16>, T<18>,
+    T<20>, T<22>, T<24>, T<26>, T<28>, T<30>, T<32>, T<34>, T<36>, T<38>,
+    T<40>, T<42>, T<44>, T<46>, T<48>, T<50>, T<52>, T<54>, T<56>, T<58>,
+    T<60>, T<62>, T<64>, T<66>, T<68>, T<70>, T<72>, T<74>, T<76>, T<78>
+  >;
+
+  for (std::size_t i = 0; i < list::size; ++i) {
+    std::size_t out = list::size;
+    EXPECT_TRUE(list::visit(i, visit_index_test_visitor(), out));
+    EXPECT_EQ(i, out);
+  }
+
+  std::size_t out = list::size;
+  EXPECT_FALSE(list::visit(list::size, visit_index_test_visitor(), out));
+  EXPECT_FALSE(list::visit(1000, visit_index_test_visitor(), out));
+  EXPECT_EQ(list::size, out);
+}
+
+struct visit_constant_test_visitor {
+  template <std::size_t Value, std::size_t Index>
+  void operator ()(
+    indexed_type_tag<std::integral_constant<std::size_t, Value>, Index>,
+    std::size_t &out
+  ) {
+    EXPECT_EQ(Value, Index);
+    out = Index;
+  }
+};
+
+TEST(type_list, visit_huge) {
+  using list = constant_range<std::size_t, 0, 130>::list;
+
+  for (std::size_t i = 0; i < list::size; ++i) {
+    std::size_t out = list::size;
+    EXPECT_TRUE(list::visit(i, visit_constant_test_visitor(), out));
+    EXPECT_EQ(i, out);
+  }
+
+  std::size_t out = list::size;
+  EXPECT_FALSE(list::visit(list::size, visit_constant_test_visitor(), out));
+  EXPECT_EQ(list::size, out);
+}
+
 //////////////////////////
 // type_list::transform //
 //////////////////////////
@@ -1019,6 +1193,28 @@ TEST(type_list, merge) {
   >();
 }
 
+// compares only the first type of a `type_pair`, to check stability
+template <typename LHS, typename RHS>
+using first_less = constants_comparison_lt<
+  typename LHS::first, typename RHS::first
+>;
+
+template <int Key, int Order>
+using keyed = type_pair<int_val<Key>, int_val<Order>>;
+
+TEST(type_list, merge_stable) {
+  expect_same<
+    type_list<
+      keyed<0, 0>, keyed<1, 1>, keyed<1, 2>, keyed<1, 5>, keyed<1, 6>,
+      keyed<2, 3>, keyed<3, 7>
+    >,
+    type_list<keyed<0, 0>, keyed<1, 1>, keyed<1, 2>, keyed<2, 3>>::merge<
+      type_list<keyed<1, 5>, keyed<1, 6>, keyed<3, 7>>,
+      first_less
+    >
+  >();
+}
+
 ///////////////////////////
 // type_list::merge_sort //
 ///////////////////////////
@@ -1084,6 +1280,19 @@ TEST(type_list, merge_sort) {
   >();
 }
 
+TEST(type_list, merge_sort_stable) {
+  expect_same<
+    type_list<
+      keyed<0, 4>, keyed<1, 0>, keyed<1, 3>, keyed<1, 6>,
+      keyed<2, 1>, keyed<2, 5>, keyed<3, 2>
+    >,
+    type_list<
+      keyed<1, 0>, keyed<2, 1>, keyed<3, 2>, keyed<1, 3>,
+      keyed<0, 4>, keyed<2, 5>, keyed<1, 6>
+    >::merge_sort<first_less>
+  >();
+}
+
 ///////////////////////
 // type_list::unique //
 ///////////////////////
@@ -1365,6 +1574,150 @@ TEST(type_list, binary_search_upper_bound) {
   check_bs_upper_bound<int, false, 524288,     -1,     mp::size, mp, -1>();
 }
 
+///////////////////////
+// type_list::lookup //
+///////////////////////
+
+template <
+  typename T,
+  bool Result, T Needle, std::size_t ExpectedIndex,
+  typename TList, T Empty
+>
+void check_lookup() {
+  auto actual = Empty;
+  std::size_t index = TList::size;
+
+  auto result = TList::template lookup<type_value_comparer>::exact(
+    Needle, bs_visitor<T>(), actual, index
+  );
+
+  auto const expectedResult = Result;
+  EXPECT_EQ(expectedResult, result);
+  auto const expectedValue = Result ? Needle : Empty;
+  EXPECT_EQ(expectedValue, actual);
+  auto const expectedIndex = ExpectedIndex;
+  EXPECT_EQ(expectedIndex, index);
+}
+
+template <typename T>
+using lookup_sparse_key = std::integral_constant<int, T::value * 3 - 500>;
+
+typedef constant_range<int, 0, 300>::list
+  ::transform<lookup_sparse_key> lookup_sparse_list;
+
+// a comparer that doesn't expose its keys
+struct lookup_size_comparer {
+  template <typename T, std::size_t Index>
+  static constexpr int compare(std::size_t lhs, indexed_type_tag<T, Index>) {
+    return lhs < sizeof(T) ? -1 : sizeof(T) < lhs ? 1 : 0;
+  }
+};
+
+TEST(type_list, lookup_strategy) {
+  EXPECT_EQ(
+    lookup_strategy::binary_search,
+    (chr_seq<>::lookup<>::strategy())
+  );
+  EXPECT_EQ(
+    lookup_strategy::direct_index,
+    (chr_seq<'x'>::lookup<>::strategy())
+  );
+  EXPECT_EQ(
+    lookup_strategy::direct_index,
+    (int_seq<-2, -1, 0, 1, 2>::lookup<>::strategy())
+  );
+  EXPECT_EQ(
+    lookup_strategy::switch_chain,
+    (chr_seq<'a', 'e', 'i', 'o', 'u'>::lookup<>::strategy())
+  );
+  EXPECT_EQ(
+    lookup_strategy::binary_search,
+    (int_seq<-1, 3, 7, 31, 127, 8191, 131071, 524287, 2147483647>
+      ::lookup<>::strategy())
+  );
+  EXPECT_EQ(
+    lookup_strategy::sorted_array,
+    lookup_sparse_list::lookup<>::strategy()
+  );
+  EXPECT_EQ(
+    lookup_strategy::binary_search,
+    (int_seq<1, 0>::lookup<>::strategy())
+  );
+  EXPECT_EQ(
+    lookup_strategy::binary_search,
+    (int_seq<0, 1, 1, 2>::lookup<>::strategy())
+  );
+  EXPECT_EQ(
+    lookup_strategy::direct_index,
+    (type_list<void, int, bool>::lookup<index_value_comparer>::strategy())
+  );
+  EXPECT_EQ(
+    lookup_strategy::binary_search,
+    (type_list<bool, int, double>::lookup<lookup_size_comparer>::strategy())
+  );
+}
+
+TEST(type_list, lookup_exact) {
+  typedef chr_seq<> empty;
+
+  LOG(INFO) << "empty";
+  check_lookup<char, false, '-', empty::size, empty, '\0'>();
+  check_lookup<int,  false, 3,   empty::size, empty, -1>();
+
+  typedef chr_seq<'x', 'y', 'z'> xyz;
+
+  LOG(INFO) << "xyz";
+  check_lookup<char, false, 'w', xyz::size, xyz, '\0'>();
+  check_lookup<char, true,  'x', 0, xyz, '\0'>();
+  check_lookup<char, true,  'y', 1, xyz, '\0'>();
+  check_lookup<char, true,  'z', 2, xyz, '\0'>();
+  check_lookup<char, false, '{', xyz::size, xyz, '\0'>();
+
+  typedef int_seq<-2, -1, 0, 1, 2> dense;
+
+  LOG(INFO) << "dense";
+  check_lookup<int, false, -3, dense::size, dense, 100>();
+  check_lookup<int, true,  -2, 0, dense, 100>();
+  check_lookup<int, true,  0,  2, dense, 100>();
+  check_lookup<int, true,  2,  4, dense, 100>();
+  check_lookup<int, false, 3,  dense::size, dense, 100>();
+
+  typedef chr_seq<'a', 'e', 'i', 'o', 'u'> aeiou;
+
+  LOG(INFO) << "aeiou";
+  check_lookup<char, false, 'x', aeiou::size, aeiou, '\0'>();
+  check_lookup<char, true,  'a', 0, aeiou, '\0'>();
+  check_lookup<char, true,  'i', 2, aeiou, '\0'>();
+  check_lookup<char, true,  'u', 4, aeiou, '\0'>();
+
+  typedef int_seq<
+    -1, 3, 7, 31, 127, 8191, 131071, 524287, 2147483647
+  > mp;
+
+  LOG(INFO) << "mp";
+  check_lookup<int, false, -2,         mp::size, mp, -5>();
+  check_lookup<int, false, 0,          mp::size, mp, -5>();
+  check_lookup<int, false, 63,         mp::size, mp, -5>();
+  check_lookup<int, true,  -1,         0, mp, -5>();
+  check_lookup<int, true,  3,          1, mp, -5>();
+  check_lookup<int, true,  127,        4, mp, -5>();
+  check_lookup<int, true,  8191,       5, mp, -5>();
+  check_lookup<int, true,  524287,     7, mp, -5>();
+  check_lookup<int, true,  2147483647, 8, mp, -5>();
+
+  typedef lookup_sparse_list sparse;
+
+  LOG(INFO) << "sparse";
+  check_lookup<int, false, -501, sparse::size, sparse, 0>();
+  check_lookup<int, true,  -500, 0, sparse, 0>();
+  check_lookup<int, false, -499, sparse::size, sparse, 0>();
+  check_lookup<int, true,  -2,   166, sparse, 0>();
+  check_lookup<int, true,  1,    167, sparse, 0>();
+  check_lookup<int, false, 2,    sparse::size, sparse, 0>();
+  check_lookup<int, true,  397,  299, sparse, 0>();
+  check_lookup<int, false, 400,  sparse::size, sparse, 0>();
+}
+
 //////////////
 // type_get //
 //////////////
@@ -8,9 +8,12 @@
  */
 
 #include <fatal/type/map.h>
+#include <fatal/type/sequence.h>
 
 #include <fatal/test/driver.h>
 
+#include <vector>
+
 namespace fatal {
 
 template <typename> struct type1_t {};
@@ -273,6 +276,20 @@ TEST(type_map, find) {
   expect_same<ibdlsv_map::find<double, not_found_type>, long>();
   expect_same<ibdlsv_map::find<short, not_found_type>, void>();
   expect_same<ibdlsv_map::find<bool, not_found_type>, not_found_type>();
+  expect_same<ibdlsv_map::find<bool>, type_not_found_tag>();
+}
+
+TEST(type_map, find_duplicate_keys) {
+  typedef type_map<
+    type_pair<int, bool>,
+    type_pair<double, long>,
+    type_pair<int, short>,
+    type_pair<double, long>
+  > map;
+
+  expect_same<map::find<int, not_found_type>, bool>();
+  expect_same<map::find<double, not_found_type>, long>();
+  expect_same<map::find<short, not_found_type>, not_found_type>();
 }
 
 //////////////
@@ -285,6 +302,10 @@ TEST(type_map, contains) {
   EXPECT_TRUE((ibdlsv_map::contains<double>::value));
   EXPECT_TRUE((ibdlsv_map::contains<short>::value));
   EXPECT_FALSE((ibdlsv_map::contains<bool>::value));
+
+  typedef type_map<type_pair<int, bool>, type_pair<int, short>> duplicates;
+  expect_same<std::true_type, duplicates::contains<int>>();
+  expect_same<std::false_type, duplicates::contains<bool>>();
 }
 
 ////////////////
@@ -1128,6 +1149,235 @@ TEST(type_map, binary_search_upper_bound) {
   check_bs_upper_bound<int, false, 524288,     -1,     -1, mp::size, mp, -1>();
 }
 
+////////////
+// lookup //
+////////////
+
+template <
+  typename T,
+  bool Result, T Needle, T ExpectedMapped, std::size_t ExpectedIndex,
+  typename TMap, T Empty
+>
+void check_lookup() {
+  auto key = Empty;
+  auto mapped = Empty;
+  std::size_t index = TMap::size;
+
+  auto result = TMap::template lookup<type_value_comparer>::exact(
+    Needle, bs_visitor<T>(), key, mapped, index
+  );
+
+  auto const expectedResult = Result;
+  EXPECT_EQ(expectedResult, result);
+  auto const expectedKey = Result ? Needle : Empty;
+  EXPECT_EQ(expectedKey, key);
+  auto const expectedMapped = Result ? ExpectedMapped : Empty;
+  EXPECT_EQ(expectedMapped, mapped);
+  auto const expectedIndex = ExpectedIndex;
+  EXPECT_EQ(expectedIndex, index);
+}
+
+template <typename T>
+using lookup_sparse_key = int_val<T::value * 3 - 500>;
+template <typename T>
+using lookup_sparse_mapped = int_val<T::value * 7>;
+
+typedef type_map_from<lookup_sparse_key, lookup_sparse_mapped>::list<
+  constant_range<int, 0, 300>::list
+> lookup_sparse_map;
+
+TEST(type_map, lookup_strategy) {
+  EXPECT_EQ(
+    lookup_strategy::binary_search,
+    (chr_map<>::lookup<>::strategy())
+  );
+  EXPECT_EQ(
+    lookup_strategy::direct_index,
+    (int_map<-1, 10, 0, 20, 1, 30>::lookup<>::strategy())
+  );
+  EXPECT_EQ(
+    lookup_strategy::switch_chain,
+    (chr_map<'a', 'A', 'e', 'E', 'i', 'I', 'o', 'O', 'u', 'U'>
+      ::lookup<>::strategy())
+  );
+  EXPECT_EQ(
+    lookup_strategy::sorted_array,
+    lookup_sparse_map::lookup<>::strategy()
+  );
+  EXPECT_EQ(
+    lookup_strategy::binary_search,
+    (int_map<1, 10, 0, 20>::lookup<>::strategy())
+  );
+  EXPECT_EQ(
+    lookup_strategy::binary_search,
+    (ibdlsv_map::lookup<>::strategy())
+  );
+}
+
+TEST(type_map, lookup_exact) {
+  typedef chr_map<> empty;
+
+  LOG(INFO) << "empty";
+  check_lookup<char, false, '-', '\0', empty::size, empty, '\0'>();
+  check_lookup<int, false, 3, -1, empty::size, empty, -1>();
+
+  typedef int_map<-1, 10, 0, 20, 1, 30> dense;
+
+  LOG(INFO) << "dense";
+  check_lookup<int, false, -2, -5, dense::size, dense, -5>();
+  check_lookup<int, true, -1, 10, 0, dense, -5>();
+  check_lookup<int, true, 1, 30, 2, dense, -5>();
+  check_lookup<int, false, 2, -5, dense::size, dense, -5>();
+
+  typedef chr_map<'a', 'A', 'e', 'E', 'i', 'I', 'o', 'O', 'u', 'U'> aeiou;
+
+  LOG(INFO) << "aeiou";
+  check_lookup<char, false, 'x', '\0', aeiou::size, aeiou, '\0'>();
+  check_lookup<char, true, 'a', 'A', 0, aeiou, '\0'>();
+  check_lookup<char, true, 'o', 'O', 3, aeiou, '\0'>();
+
+  typedef int_map<
+    3, 2, 7, 3, 31, 5, 127, 7, 8191, 13, 131071, 17, 524287, 19, 2147483647, 31
+  > mp;
+
+  LOG(INFO) << "mp";
+  check_lookup<int, false, 63, -1, mp::size, mp, -1>();
+  check_lookup<int, true, 3, 2, 0, mp, -1>();
+  check_lookup<int, true, 2147483647, 31, 7, mp, -1>();
+
+  typedef lookup_sparse_map sparse;
+
+  LOG(INFO) << "sparse";
+  check_lookup<int, false, -501, -1, sparse::size, sparse, -1>();
+  check_lookup<int, true, -500, 0, 0, sparse, -1>();
+  check_lookup<int, false, -499, -1, sparse::size, sparse, -1>();
+  check_lookup<int, true, -2, 1162, 166, sparse, -1>();
+  check_lookup<int, true, 1, 1169, 167, sparse, -1>();
+  check_lookup<int, false, 2, -1, sparse::size, sparse, -1>();
+  check_lookup<int, true, 397, 2093, 299, sparse, -1>();
+  check_lookup<int, false, 400, -1, sparse::size, sparse, -1>();
+}
+
+///////////////////
+// mapped_lookup //
+///////////////////
+
+struct mapped_lookup_visitor {
+  template <int Mapped, std::size_t Index>
+  void operator ()(
+    indexed_type_tag<int_val<Mapped>, Index>,
+    int needle,
+    int &key,
+    int &mapped,
+    std::size_t &index
+  ) {
+    key = needle;
+    mapped = Mapped;
+    index = Index;
+  };
+};
+
+// exposes no keys, therefore `mapped_lookup` falls back to `binary_search`
+struct mapped_lookup_keyless_comparer {
+  template <typename TLHS, typename TRHS, std::size_t Index>
+  static constexpr int compare(TLHS &&lhs, indexed_type_tag<TRHS, Index> rhs) {
+    return type_value_comparer::compare(std::forward<TLHS>(lhs), rhs);
+  }
+};
+
+template <
+  bool Result, int Needle, int ExpectedMapped, std::size_t ExpectedIndex,
+  typename TMap, typename TComparer = type_value_comparer
+>
+void check_mapped_lookup() {
+  int key = -1;
+  int mapped = -1;
+  std::size_t index = TMap::size;
+
+  auto result = TMap::template mapped_lookup<TComparer>::exact(
+    Needle, mapped_lookup_visitor(), key, mapped, index
+  );
+
+  auto const expectedResult = Result;
+  EXPECT_EQ(expectedResult, result);
+  auto const expectedKey = Result ? Needle : -1;
+  EXPECT_EQ(expectedKey, key);
+  auto const expectedMapped = Result ? ExpectedMapped : -1;
+  EXPECT_EQ(expectedMapped, mapped);
+  auto const expectedIndex = ExpectedIndex;
+  EXPECT_EQ(expectedIndex, index);
+}
+
+template <typename T>
+using mapped_lookup_group = int_val<(T::value % 3) * 10>;
+
+typedef type_map_from<lookup_sparse_key, mapped_lookup_group>::list<
+  constant_range<int, 0, 300>::list
+> mapped_lookup_map;
+
+TEST(type_map, mapped_lookup) {
+  typedef int_map<> empty;
+
+  LOG(INFO) << "empty";
+  EXPECT_FALSE(empty::mapped_lookup<>::sorted_array());
+  check_mapped_lookup<false, 3, -1, empty::size, empty>();
+
+  EXPECT_FALSE((int_map<1, 10, 0, 20>::mapped_lookup<>::sorted_array()));
+
+  typedef int_map<0, 20, 1, 10, 2, 20, 4, 10> keyless;
+  typedef mapped_lookup_keyless_comparer cmp;
+
+  LOG(INFO) << "keyless";
+  EXPECT_FALSE(keyless::mapped_lookup<cmp>::sorted_array());
+  check_mapped_lookup<true, 0, 20, 0, keyless, cmp>();
+  check_mapped_lookup<true, 1, 10, 1, keyless, cmp>();
+  check_mapped_lookup<true, 2, 20, 0, keyless, cmp>();
+  check_mapped_lookup<false, 3, -1, keyless::size, keyless, cmp>();
+  check_mapped_lookup<true, 4, 10, 1, keyless, cmp>();
+
+  typedef int_map<3, 7, 5, 7> single;
+
+  LOG(INFO) << "single";
+  EXPECT_TRUE(single::mapped_lookup<>::sorted_array());
+  check_mapped_lookup<false, 2, -1, single::size, single>();
+  check_mapped_lookup<true, 3, 7, 0, single>();
+  check_mapped_lookup<false, 4, -1, single::size, single>();
+  check_mapped_lookup<true, 5, 7, 0, single>();
+  check_mapped_lookup<false, 6, -1, single::size, single>();
+
+  typedef mapped_lookup_map sparse;
+
+  LOG(INFO) << "sparse";
+  EXPECT_TRUE(sparse::mapped_lookup<>::sorted_array());
+  expect_same<
+    type_list<int_val<0>, int_val<10>, int_val<20>>,
+    sparse::mapped::unique<>
+  >();
+  check_mapped_lookup<false, -501, -1, sparse::size, sparse>();
+  check_mapped_lookup<true, -500, 0, 0, sparse>();
+  check_mapped_lookup<false, -499, -1, sparse::size, sparse>();
+  check_mapped_lookup<true, -2, 10, 1, sparse>();
+  check_mapped_lookup<true, 1, 20, 2, sparse>();
+  check_mapped_lookup<false, 2, -1, sparse::size, sparse>();
+  check_mapped_lookup<true, 397, 20, 2, sparse>();
+  check_mapped_lookup<false, 400, -1, sparse::size, sparse>();
+
+  for (int i = 0; i < 300; ++i) {
+    int key = -1;
+    int mapped = -1;
+    std::size_t index = sparse::size;
+
+    EXPECT_TRUE(
+      sparse::mapped_lookup<>::exact(
+        i * 3 - 500, mapped_lookup_visitor(), key, mapped, index
+      )
+    );
+    EXPECT_EQ(i * 3 - 500, key);
+    EXPECT_EQ((i % 3) * 10, mapped);
+    EXPECT_EQ(static_cast<std::size_t>(i % 3), index);
+  }
+}
+
 //////////////
 // type_get //
 //////////////
@@ -1368,4 +1618,86 @@ TEST(type_map, clustered_index) {
   >();
 }
 
+////////////////////////
+// clustered_dispatch //
+////////////////////////
+
+struct clustered_dispatch_visitor {
+  template <typename... TKeys, typename T, std::size_t Index>
+  void operator ()(
+    indexed_type_tag<type_pair<type_list<TKeys...>, T>, Index>,
+    std::vector<int> &keys,
+    int &value,
+    std::size_t &index
+  ) {
+    keys = { TKeys::value... };
+    value = T::value;
+    index = Index;
+  }
+};
+
+template <typename TDispatch, int... ExpectedKeys, typename... UIndexes>
+void check_clustered_dispatch(
+  bool expectedResult,
+  int expectedValue,
+  UIndexes... indexes
+) {
+  std::vector<int> keys;
+  int value = -1;
+  std::size_t index = TDispatch::size;
+
+  auto const flat = TDispatch::index(indexes...);
+  auto const result = TDispatch::visit(
+    flat, clustered_dispatch_visitor(), keys, value, index
+  );
+
+  EXPECT_EQ(expectedResult, result);
+  EXPECT_EQ(std::vector<int>({ ExpectedKeys... }), keys);
+  EXPECT_EQ(expectedValue, value);
+  EXPECT_EQ(result ? flat : TDispatch::size, index);
+}
+
+TEST(type_map, clustered_dispatch) {
+  // x1 -> { y1 -> 11, y3 -> 13 }, x2 -> { y2 -> 22 }
+  typedef build_type_map<
+    x1, build_type_map<y1, int_val<11>, y3, int_val<13>>,
+    x2, build_type_map<y2, int_val<22>>
+  > map;
+
+  typedef clustered_dispatch<
+    map,
+    type_list<x1, x2, x3>,
+    type_list<y1, y2, y3>
+  > dispatch;
+
+  EXPECT_EQ(9, dispatch::size);
+
+  EXPECT_EQ(0, dispatch::index(0, 0));
+  EXPECT_EQ(2, dispatch::index(0, 2));
+  EXPECT_EQ(4, dispatch::index(1, 1));
+  EXPECT_EQ(8, dispatch::index(2, 2));
+  EXPECT_EQ(dispatch::size, dispatch::index(3, 0));
+  EXPECT_EQ(dispatch::size, dispatch::index(0, 3));
+
+  check_clustered_dispatch<dispatch, 101, 201>(true, 11, 0, 0);
+  check_clustered_dispatch<dispatch, 101, 203>(true, 13, 0, 2);
+  check_clustered_dispatch<dispatch, 102, 202>(true, 22, 1, 1);
+  check_clustered_dispatch<dispatch>(false, -1, 0, 1);
+  check_clustered_dispatch<dispatch>(false, -1, 1, 0);
+  check_clustered_dispatch<dispatch>(false, -1, 2, 0);
+  check_clustered_dispatch<dispatch>(false, -1, 3, 0);
+  check_clustered_dispatch<dispatch>(false, -1, 0, 3);
+
+  typedef clustered_dispatch<
+    build_type_map<x1, int_val<1>, x2, int_val<2>>,
+    type_list<x3, x2, x1>
+  > single;
+
+  EXPECT_EQ(3, single::size);
+  check_clustered_dispatch<single>(false, -1, 0);
+  check_clustered_dispatch<single, 102>(true, 2, 1);
+  check_clustered_dispatch<single, 101>(true, 1, 2);
+  check_clustered_dispatch<single>(false, -1, 3);
+}
+
 } // namespace fatal {
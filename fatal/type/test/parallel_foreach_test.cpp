@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2014, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ */
+
+#include <fatal/type/parallel_foreach.h>
+
+#include <fatal/type/sequence.h>
+
+#include <fatal/test/driver.h>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace fatal {
+
+typedef constant_range<std::size_t, 0, 40>::list list;
+
+struct count_visitor {
+  template <typename T, std::size_t Index>
+  void operator ()(
+    indexed_type_tag<T, Index>,
+    std::array<std::atomic<std::size_t>, list::size> &visits,
+    std::atomic<std::size_t> &sum
+  ) const {
+    static_assert(T::value == Index, "index mismatch");
+    ++visits[Index];
+    sum += T::value;
+  }
+};
+
+struct throwing_visitor {
+  template <typename T, std::size_t Index>
+  void operator ()(indexed_type_tag<T, Index>, std::atomic<std::size_t> &count) {
+    ++count;
+
+    if (Index == 7) {
+      throw std::runtime_error("failed");
+    }
+  }
+};
+
+// runs each task on its own thread
+struct thread_executor {
+  ~thread_executor() {
+    for (auto &thread: threads) {
+      thread.join();
+    }
+  }
+
+  void add(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.emplace_back(std::move(task));
+  }
+
+  std::mutex mutex;
+  std::vector<std::thread> threads;
+};
+
+// runs each task in place
+struct inline_executor {
+  void add(std::function<void()> task) {
+    ++tasks;
+    task();
+  }
+
+  std::size_t tasks = 0;
+};
+
+template <typename... Args>
+void check_visits(Args &&...args) {
+  std::array<std::atomic<std::size_t>, list::size> visits;
+  for (auto &i: visits) {
+    i = 0;
+  }
+  std::atomic<std::size_t> sum(0);
+
+  EXPECT_TRUE(
+    parallel_foreach<list>(std::forward<Args>(args)..., visits, sum)
+  );
+
+  for (auto &i: visits) {
+    EXPECT_EQ(1, i.load());
+  }
+  EXPECT_EQ(list::size * (list::size - 1) / 2, sum.load());
+}
+
+TEST(parallel_foreach, built_in) {
+  check_visits(count_visitor());
+
+  std::atomic<std::size_t> count(0);
+  EXPECT_FALSE(parallel_foreach<type_list<>>(count_visitor(), count));
+  EXPECT_EQ(0, count.load());
+}
+
+TEST(parallel_foreach, executor) {
+  thread_executor threads;
+  check_visits(threads, count_visitor());
+  EXPECT_EQ(list::size - 1, threads.threads.size());
+
+  inline_executor in_place;
+  check_visits(in_place, count_visitor());
+  EXPECT_EQ(list::size - 1, in_place.tasks);
+
+  EXPECT_FALSE(parallel_foreach<type_list<>>(in_place, count_visitor()));
+}
+
+TEST(parallel_foreach, exception) {
+  std::atomic<std::size_t> count(0);
+
+  EXPECT_THROW(
+    parallel_foreach<list>(throwing_visitor(), count),
+    std::runtime_error
+  );
+  EXPECT_LE(8, count.load());
+
+  thread_executor threads;
+  count = 0;
+
+  EXPECT_THROW(
+    parallel_foreach<list>(threads, throwing_visitor(), count),
+    std::runtime_error
+  );
+  EXPECT_LE(8, count.load());
+}
+
+} // namespace fatal {
@@ -14,6 +14,8 @@
 
 #include <folly/Conv.h>
 
+#include <array>
+#include <string>
 #include <type_traits>
 
 namespace fatal {
@@ -329,6 +331,84 @@ struct check_match {
   }
 };
 
+///////////////
+// sequences //
+///////////////
+
+TEST(type_prefix_tree, sequences) {
+  typedef type_prefix_tree_builder<> builder;
+  expect_same<type_list<>, builder::build<>::sequences::list>();
+  expect_same<type_list<a>, builder::build<a>::sequences::list>();
+
+  expect_same<
+    type_list<h, ha, hat, hi, hint, hit, ho, hot>,
+    hs_tree::sequences::list
+  >();
+
+  expect_same<
+    type_list<h, ha, hat, hi, hint, hit, ho, hot>,
+    builder::build<hot, hint, h, hat, ho, hit, hi, ha>::sequences::list
+  >();
+
+  expect_same<
+    type_list<a, ab, abc, abcd, abcde, abcdef, abcx, abcxy, abcxyz>,
+    abc_tree::sequences::list
+  >();
+}
+
+/////////////////
+// match_index //
+/////////////////
+
+template <typename TTree>
+void check_match_index(std::string const &needle, std::size_t expected) {
+  EXPECT_EQ(
+    expected,
+    TTree::template match<>::index(needle.begin(), needle.end())
+  );
+}
+
+TEST(type_prefix_tree, match_index) {
+  typedef hs_tree::sequences seqs;
+
+  check_match_index<hs_tree>("", seqs::size);
+  check_match_index<hs_tree>("h", seqs::index_of<h>::value);
+  check_match_index<hs_tree>("ha", seqs::index_of<ha>::value);
+  check_match_index<hs_tree>("hat", seqs::index_of<hat>::value);
+  check_match_index<hs_tree>("hi", seqs::index_of<hi>::value);
+  check_match_index<hs_tree>("hint", seqs::index_of<hint>::value);
+  check_match_index<hs_tree>("hit", seqs::index_of<hit>::value);
+  check_match_index<hs_tree>("ho", seqs::index_of<ho>::value);
+  check_match_index<hs_tree>("hot", seqs::index_of<hot>::value);
+  check_match_index<hs_tree>("H", seqs::size);
+  check_match_index<hs_tree>("hin", seqs::size);
+  check_match_index<hs_tree>("hut", seqs::size);
+  check_match_index<hs_tree>("hints", seqs::size);
+
+  typedef abc_tree::sequences abc_seqs;
+  check_match_index<abc_tree>("abcx", abc_seqs::index_of<abcx>::value);
+  check_match_index<abc_tree>("abcxz", abc_seqs::size);
+
+  typedef type_prefix_tree_builder<>::build<> empty;
+  check_match_index<empty>("", 0);
+  check_match_index<empty>("a", 0);
+}
+
+TEST(type_prefix_tree, match_index_counters) {
+  std::array<std::size_t, hs_tree::sequences::size + 1> counters{};
+
+  for (std::string const s: {"hat", "hit", "hat", "hut", "h", "hat", "x"}) {
+    ++counters[hs_tree::match<>::index(s.begin(), s.end())];
+  }
+
+  typedef hs_tree::sequences seqs;
+  EXPECT_EQ(3, counters[seqs::index_of<hat>::value]);
+  EXPECT_EQ(1, counters[seqs::index_of<hit>::value]);
+  EXPECT_EQ(1, counters[seqs::index_of<h>::value]);
+  EXPECT_EQ(0, counters[seqs::index_of<hot>::value]);
+  EXPECT_EQ(2, counters[seqs::size]);
+}
+
 /////////////////
 // match_exact //
 /////////////////
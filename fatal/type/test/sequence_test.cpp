@@ -11,6 +11,10 @@
 
 #include <fatal/test/driver.h>
 
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
 namespace fatal {
 
 /////////////////////////////
@@ -399,6 +403,59 @@ TEST(constant_sequence, z_array) {
   check_z_array<char, 'x', '1', '2', '3', '4', '5'>();
 }
 
+///////////////////////////////
+// constant_sequence::bucket //
+///////////////////////////////
+
+template <typename TSequence, typename T>
+void check_bucket(T begin, T end) {
+  auto const boundaries = TSequence::array();
+
+  for (auto i = begin; i != end; ++i) {
+    auto const expected = static_cast<std::size_t>(
+      std::upper_bound(boundaries.begin(), boundaries.end(), i)
+        - boundaries.begin()
+    );
+
+    EXPECT_EQ(expected, TSequence::bucket(i));
+  }
+}
+
+TEST(constant_sequence, bucket) {
+  check_bucket<constant_sequence<int>>(-5, 5);
+  check_bucket<constant_sequence<int, 0>>(-5, 5);
+  check_bucket<constant_sequence<int, 10, 20, 30>>(0, 40);
+  check_bucket<constant_sequence<int, -3, 1, 1, 4, 4, 4, 9>>(-10, 20);
+  check_bucket<constant_sequence<char, 'b', 'd', 'x'>>('a', 'z');
+
+  // long enough to be binary searched
+  check_bucket<constant_range<int, 0, 33>>(-5, 40);
+  check_bucket<constant_range<int, 0, 64>>(-5, 70);
+  check_bucket<constant_range<int, 0, 100>>(-5, 105);
+  check_bucket<constant_range<unsigned, 10, 110>>(0u, 120u);
+}
+
+//////////////////////////////////
+// constant_sequence::bucketize //
+//////////////////////////////////
+
+TEST(constant_sequence, bucketize) {
+  typedef constant_sequence<int, 10, 20, 30> seq;
+
+  std::vector<int> const values{5, 20, 29, 99, 10, -1};
+  std::vector<std::size_t> buckets(values.size());
+
+  auto const end = seq::bucketize(values.begin(), values.end(), buckets.begin());
+  EXPECT_EQ(buckets.end(), end);
+  EXPECT_EQ((std::vector<std::size_t>{0, 2, 2, 3, 1, 0}), buckets);
+
+  std::vector<std::size_t> long_buckets;
+  constant_range<int, 0, 100>::bucketize(
+    values.begin(), values.end(), std::back_inserter(long_buckets)
+  );
+  EXPECT_EQ((std::vector<std::size_t>{6, 21, 30, 100, 11, 0}), long_buckets);
+}
+
 ////////////////////
 // constant_range //
 ////////////////////